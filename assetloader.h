@@ -0,0 +1,128 @@
+const size_t ASSET_UPLOAD_BUDGET = 8 * 1024 * 1024;
+
+struct DecodedSurface {
+    std::string path;
+    SDL_Surface* surface;
+};
+
+// Giải mã PNG trên các luồng phụ; luồng chính chỉ upload surface thành texture theo ngân sách mỗi frame
+struct AssetLoader {
+    std::vector<SDL_Thread*> workers;
+    SDL_mutex* mutex;
+    SDL_cond* workAvailable;
+    std::deque<std::string> pending;
+    std::deque<DecodedSurface> decoded;
+    std::unordered_set<std::string> requested;
+    int inFlight;
+    bool stopping;
+    size_t uploadBudget;
+
+    void init(int workerCount, size_t uploadBudget = ASSET_UPLOAD_BUDGET) {
+        mutex = SDL_CreateMutex();
+        workAvailable = SDL_CreateCond();
+        inFlight = 0;
+        stopping = false;
+        this->uploadBudget = uploadBudget;
+        for (int i = 0; i < workerCount; i++) {
+            SDL_Thread* thread = SDL_CreateThread(workerMain, "asset-loader", this);
+            if (thread) workers.push_back(thread);
+            else std::cerr << "❌ Không tạo được luồng tải tài nguyên: " << SDL_GetError() << std::endl;
+        }
+    }
+
+    void request(const std::string& path, const TextureManager& textureManager) {
+        std::string file = textureManager.sourceFile(path);
+        if (textureManager.isLoaded(file) || requested.count(file)) return;
+        if (assetBundle.findPath(file)) return;
+        requested.insert(file);
+        if (workers.empty()) return;
+        SDL_LockMutex(mutex);
+        pending.push_back(file);
+        inFlight++;
+        SDL_CondSignal(workAvailable);
+        SDL_UnlockMutex(mutex);
+    }
+
+    void requestAll(const std::vector<std::string>& paths, const TextureManager& textureManager) {
+        for (const auto& path : paths) request(path, textureManager);
+    }
+
+    // Gọi mỗi frame từ luồng chính; luôn upload ít nhất một surface để không bị kẹt với ảnh lớn
+    int pump(TextureManager& textureManager) {
+        int uploaded = 0;
+        size_t bytes = 0;
+        while (uploaded == 0 || bytes < uploadBudget) {
+            SDL_LockMutex(mutex);
+            if (decoded.empty()) {
+                SDL_UnlockMutex(mutex);
+                break;
+            }
+            DecodedSurface item = decoded.front();
+            decoded.pop_front();
+            inFlight--;
+            SDL_UnlockMutex(mutex);
+
+            requested.erase(item.path);
+            if (item.surface) {
+                bytes += static_cast<size_t>(item.surface->w) * item.surface->h * 4;
+                textureManager.adopt(item.path, item.surface);
+            }
+            uploaded++;
+        }
+        return uploaded;
+    }
+
+    bool isIdle() {
+        SDL_LockMutex(mutex);
+        bool idle = inFlight == 0;
+        SDL_UnlockMutex(mutex);
+        return idle;
+    }
+
+    // Chờ và upload toàn bộ những gì đã yêu cầu (dùng khi không còn frame nào để giấu việc tải)
+    void finish(TextureManager& textureManager) {
+        while (!isIdle()) {
+            if (pump(textureManager) == 0) SDL_Delay(1);
+        }
+    }
+
+    static int workerMain(void* data) {
+        AssetLoader* loader = static_cast<AssetLoader*>(data);
+        while (true) {
+            SDL_LockMutex(loader->mutex);
+            while (loader->pending.empty() && !loader->stopping) {
+                SDL_CondWait(loader->workAvailable, loader->mutex);
+            }
+            if (loader->stopping) {
+                SDL_UnlockMutex(loader->mutex);
+                return 0;
+            }
+            std::string path = loader->pending.front();
+            loader->pending.pop_front();
+            SDL_UnlockMutex(loader->mutex);
+
+            SDL_Surface* surface = IMG_Load(path.c_str());
+            if (!surface) std::cerr << "❌ Không tải được " << path << ": " << IMG_GetError() << std::endl;
+
+            SDL_LockMutex(loader->mutex);
+            loader->decoded.push_back({ path, surface });
+            SDL_UnlockMutex(loader->mutex);
+        }
+    }
+
+    void cleanup() {
+        SDL_LockMutex(mutex);
+        stopping = true;
+        SDL_CondBroadcast(workAvailable);
+        SDL_UnlockMutex(mutex);
+        for (SDL_Thread* thread : workers) SDL_WaitThread(thread, NULL);
+        workers.clear();
+        for (auto& item : decoded) {
+            if (item.surface) SDL_FreeSurface(item.surface);
+        }
+        decoded.clear();
+        pending.clear();
+        SDL_DestroyCond(workAvailable);
+        SDL_DestroyMutex(mutex);
+    }
+};
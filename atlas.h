@@ -0,0 +1,46 @@
+struct AtlasFrame {
+    int page;
+    SDL_Rect rect;
+};
+
+// Bảng frame do tools/atlaspacker sinh ra: mỗi sheet là một vùng con trong một trang atlas
+struct Atlas {
+    std::vector<std::string> pageFiles;
+    std::unordered_map<std::string, AtlasFrame> frames;
+
+    bool load(const std::string& tablePath) {
+        std::ifstream file(tablePath);
+        if (!file.is_open()) return false;
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream iss(line);
+            std::string kind;
+            if (!(iss >> kind) || kind[0] == '#') continue;
+            if (kind == "pages") {
+                int count = 0;
+                iss >> count;
+                pageFiles.resize(count);
+            } else if (kind == "page") {
+                int index = -1;
+                std::string name;
+                iss >> index >> name;
+                if (index >= 0 && index < static_cast<int>(pageFiles.size())) pageFiles[index] = name;
+            } else if (kind == "sheet") {
+                std::string name;
+                AtlasFrame frame;
+                if (iss >> name >> frame.page >> frame.rect.x >> frame.rect.y >> frame.rect.w >> frame.rect.h &&
+                    frame.page >= 0 && frame.page < static_cast<int>(pageFiles.size())) {
+                    frames[name] = frame;
+                }
+            }
+        }
+        file.close();
+        return !frames.empty();
+    }
+
+    const AtlasFrame* find(const std::string& name) const {
+        auto it = frames.find(name);
+        return it != frames.end() ? &it->second : nullptr;
+    }
+};
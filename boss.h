@@ -1,34 +1,25 @@
+const float BOSS_SPAWN_OFFSET = 150.0f;   // Boss đứng lệch phải so với nhóm ô của nó
+
+// Boss cuối game. Trạng thái nóng nằm trong EntityColumns<Boss>, struct này chỉ là phần cold.
 struct Boss {
-    float x, y;
-    float speed;
-    bool movingRight;
-    float min_x, max_x;
-    std::vector<SDL_Texture*> moveTextures;
-    std::vector<SDL_Texture*> attackTextures;
-    std::vector<SDL_Texture*> dyingTextures;
-    SDL_Texture* hurtTexture;
-    SDL_Texture* idleTexture;
-    int currentFrame;
-    int moveFrameCount;
-    int attackFrameCount;
-    int dyingFrameCount;
-    int hurtFrameCount;
-    int idleFrameCount;
-    int moveFrameDelay;
-    int attackFrameDelay;
-    int dyingFrameDelay;
-    int hurtFrameDelay;
-    int idleFrameDelay;
-    int frameTimer;
-    bool isAttacking;
-    bool isDying;
-    bool toRemove;
-    bool isHurt;
-    bool isIdle;
-    bool isMoving;
-    int hitCount;
-    int attackCooldown;
-    int attackCooldownMax;
+    static constexpr int moveFrameCount = 6;
+    static constexpr int attackFrameCount = 5;
+    static constexpr int dyingFrameCount = 6;
+    static constexpr int hurtFrameCount = 5;
+    static constexpr int idleFrameCount = 6;
+    static constexpr int moveFrameDelay = 8;
+    static constexpr int attackFrameDelay = 8;
+    static constexpr int dyingFrameDelay = 9;
+    static constexpr int hurtFrameDelay = 8;
+    static constexpr int idleFrameDelay = 8;
+    static constexpr int attackCooldownMax = 60;
+    static constexpr int attackDamage = 20;
+
+    std::vector<TextureHandle> moveTextures;
+    std::vector<TextureHandle> attackTextures;
+    std::vector<TextureHandle> dyingTextures;
+    TextureHandle hurtTexture;
+    TextureHandle idleTexture;
     int currentMoveSheetIndex;
     int currentAttackSheetIndex;
     int currentDyingSheetIndex;
@@ -41,77 +32,43 @@ struct Boss {
     int shakeDelayTimer;
     bool attackDirection; // Thuộc tính mới
 
-    void init(SDL_Renderer* renderer, float start_x, float start_y, float min_x, float max_x) {
-        float offset = 150.0f;
-        x = start_x + offset;
-        y = start_y - 10.0f;
-        speed = 1.2f;
-        movingRight = true;
-        this->min_x = min_x + offset;
-        this->max_x = max_x + offset;
+    static void listAssets(std::vector<std::string>& paths) {
+        for (int i = 0; i < 2; ++i) paths.push_back(ASSETS_PATH + "boss_move" + std::to_string(i + 1) + "_sheet.png");
+        for (int i = 0; i < 3; ++i) paths.push_back(ASSETS_PATH + "boss_attack" + std::to_string(i + 1) + "_sheet.png");
+        for (int i = 0; i < 3; ++i) paths.push_back(ASSETS_PATH + "boss_dying" + std::to_string(i + 1) + "_sheet.png");
+        paths.push_back(ASSETS_PATH + "boss_hurt_sheet.png");
+        paths.push_back(ASSETS_PATH + "boss_Idle_sheet.png");
+    }
+
+    static size_t spawn(EntityColumns<Boss>& columns, float start_x, float start_y, float min_x, float max_x, TextureManager& textureManager) {
+        float offset = BOSS_SPAWN_OFFSET;
+        size_t i = columns.add(start_x + offset, start_y - 10.0f, min_x + offset, max_x + offset, 1.2f);
+        columns.isMoving[i] = true;
+        columns.cold[i].init(textureManager);
+        return i;
+    }
 
+    void init(TextureManager& textureManager) {
         scale = 1.5f;
 
-        moveTextures.resize(2, nullptr);
+        moveTextures.resize(2);
         for (int i = 0; i < 2; ++i) {
-            std::string movePath = ASSETS_PATH + "boss_move" + std::to_string(i + 1) + "_sheet.png";
-            SDL_Surface* moveSurface = IMG_Load(movePath.c_str());
-            moveTextures[i] = moveSurface ? SDL_CreateTextureFromSurface(renderer, moveSurface) : nullptr;
-            if (!moveSurface) std::cerr << "❌ Không tải được " << movePath << ": " << IMG_GetError() << std::endl;
-            if (moveSurface) SDL_FreeSurface(moveSurface);
+            moveTextures[i] = textureManager.acquire(ASSETS_PATH + "boss_move" + std::to_string(i + 1) + "_sheet.png");
         }
 
-        attackTextures.resize(3, nullptr);
+        attackTextures.resize(3);
         for (int i = 0; i < 3; ++i) {
-            std::string attackPath = ASSETS_PATH + "boss_attack" + std::to_string(i + 1) + "_sheet.png";
-            SDL_Surface* attackSurface = IMG_Load(attackPath.c_str());
-            attackTextures[i] = attackSurface ? SDL_CreateTextureFromSurface(renderer, attackSurface) : nullptr;
-            if (!attackSurface) std::cerr << "❌ Không tải được " << attackPath << ": " << IMG_GetError() << std::endl;
-            if (attackSurface) SDL_FreeSurface(attackSurface);
+            attackTextures[i] = textureManager.acquire(ASSETS_PATH + "boss_attack" + std::to_string(i + 1) + "_sheet.png");
         }
 
-        dyingTextures.resize(3, nullptr);
+        dyingTextures.resize(3);
         for (int i = 0; i < 3; ++i) {
-            std::string dyingPath = ASSETS_PATH + "boss_dying" + std::to_string(i + 1) + "_sheet.png";
-            SDL_Surface* dyingSurface = IMG_Load(dyingPath.c_str());
-            dyingTextures[i] = dyingSurface ? SDL_CreateTextureFromSurface(renderer, dyingSurface) : nullptr;
-            if (!dyingSurface) std::cerr << "❌ Không tải được " << dyingPath << ": " << IMG_GetError() << std::endl;
-            if (dyingSurface) SDL_FreeSurface(dyingSurface);
+            dyingTextures[i] = textureManager.acquire(ASSETS_PATH + "boss_dying" + std::to_string(i + 1) + "_sheet.png");
         }
 
-        std::string hurtPath = ASSETS_PATH + "boss_hurt_sheet.png";
-        SDL_Surface* hurtSurface = IMG_Load(hurtPath.c_str());
-        hurtTexture = hurtSurface ? SDL_CreateTextureFromSurface(renderer, hurtSurface) : nullptr;
-        if (!hurtSurface) std::cerr << "❌ Không tải được " << hurtPath << ": " << IMG_GetError() << std::endl;
-        if (hurtSurface) SDL_FreeSurface(hurtSurface);
-
-        std::string idlePath = ASSETS_PATH + "boss_Idle_sheet.png";
-        SDL_Surface* idleSurface = IMG_Load(idlePath.c_str());
-        idleTexture = idleSurface ? SDL_CreateTextureFromSurface(renderer, idleSurface) : nullptr;
-        if (!idleSurface) std::cerr << "❌ Không tải được " << idlePath << ": " << IMG_GetError() << std::endl;
-        if (idleSurface) SDL_FreeSurface(idleSurface);
-
-        currentFrame = 0;
-        moveFrameCount = 6;
-        attackFrameCount = 5;
-        dyingFrameCount = 6;
-        hurtFrameCount = 5;
-        idleFrameCount = 6;
-        moveFrameDelay = 8;
-        attackFrameDelay = 8;
-        dyingFrameDelay = 9;
-        hurtFrameDelay = 8;
-        idleFrameDelay = 8;
-        frameTimer = 0;
-        isAttacking = false;
-        isDying = false;
-        toRemove = false;
-        isHurt = false;
-        isIdle = true;
-        isMoving = true;
-        hitCount = 0;
-        attackCooldown = 0;
-        attackCooldownMax = 60;
+        hurtTexture = textureManager.acquire(ASSETS_PATH + "boss_hurt_sheet.png");
+        idleTexture = textureManager.acquire(ASSETS_PATH + "boss_Idle_sheet.png");
+
         currentMoveSheetIndex = 0;
         currentAttackSheetIndex = (lastAttackSheetIndex + 1) % 3;
         lastAttackSheetIndex = currentAttackSheetIndex;
@@ -125,7 +82,19 @@ struct Boss {
         attackDirection = true; // Giá trị khởi tạo mặc định
     }
 
-    void update(float playerX, float playerY, Camera& camera) {
+    static void update(EntityColumns<Boss>& columns, size_t i, float playerX, float playerY, Camera& camera) {
+        Boss& boss = columns.cold[i];
+        float& x = columns.x[i];
+        uint8_t& movingRight = columns.movingRight[i];
+        int& currentFrame = columns.currentFrame[i];
+        int& frameTimer = columns.frameTimer[i];
+        uint8_t& isAttacking = columns.isAttacking[i];
+        uint8_t& isHurt = columns.isHurt[i];
+        uint8_t& isDying = columns.isDying[i];
+        uint8_t& isIdle = columns.isIdle[i];
+        uint8_t& isMoving = columns.isMoving[i];
+        int& attackCooldown = columns.attackCooldown[i];
+
         int currentFrameDelay = isDying ? dyingFrameDelay :
                                 isHurt ? hurtFrameDelay :
                                 isAttacking ? attackFrameDelay :
@@ -139,9 +108,9 @@ struct Boss {
                 currentFrame++;
                 if (currentFrame >= dyingFrameCount) {
                     currentFrame = 0;
-                    currentDyingSheetIndex++;
-                    if (currentDyingSheetIndex >= 3) {
-                        toRemove = true;
+                    boss.currentDyingSheetIndex++;
+                    if (boss.currentDyingSheetIndex >= 3) {
+                        columns.toRemove[i] = true;
                     }
                 }
             }
@@ -165,15 +134,15 @@ struct Boss {
                 isMoving = false;
                 currentFrame = 0;
                 isIdle = false;
-                currentAttackSheetIndex = (lastAttackSheetIndex + 1) % 3;
-                lastAttackSheetIndex = currentAttackSheetIndex;
-                shouldShake = false;
-                shakeDelayTimer = 120;
+                boss.currentAttackSheetIndex = (lastAttackSheetIndex + 1) % 3;
+                lastAttackSheetIndex = boss.currentAttackSheetIndex;
+                boss.shouldShake = false;
+                boss.shakeDelayTimer = 120;
                 // Xác định hướng tấn công dựa trên vị trí người chơi
                 if (playerX < x) {
-                    attackDirection = false; // Người chơi ở bên trái -> tấn công sang trái
+                    boss.attackDirection = false; // Người chơi ở bên trái -> tấn công sang trái
                 } else {
-                    attackDirection = true;  // Người chơi ở bên phải -> tấn công sang phải
+                    boss.attackDirection = true;  // Người chơi ở bên phải -> tấn công sang phải
                 }
             }
 
@@ -183,33 +152,33 @@ struct Boss {
                     frameTimer = 0;
                     currentFrame++;
                     if (currentFrame >= attackFrameCount) {
-                        if (currentAttackSheetIndex == 1) { // Sheet thứ 2 (index 1)
+                        if (boss.currentAttackSheetIndex == 1) { // Sheet thứ 2 (index 1)
                             camera.startShake(10, 20);
                         }
                         isAttacking = false;
                         currentFrame = 0;
                         isIdle = true;
                         isMoving = true;
-                        shouldShake = false;
+                        boss.shouldShake = false;
                     }
                 }
-                if (shakeDelayTimer > 0) {
-                    shakeDelayTimer--;
+                if (boss.shakeDelayTimer > 0) {
+                    boss.shakeDelayTimer--;
                 }
             } else if (isIdle && isMoving) {
                 if (movingRight) {
-                    x += speed;
-                    if (x >= max_x) {
-                        x = max_x;
+                    x += columns.speed[i];
+                    if (x >= columns.maxX[i]) {
+                        x = columns.maxX[i];
                         movingRight = false;
-                        currentMoveSheetIndex = (currentMoveSheetIndex + 1) % 2;
+                        boss.currentMoveSheetIndex = (boss.currentMoveSheetIndex + 1) % 2;
                     }
                 } else {
-                    x -= speed;
-                    if (x <= min_x) {
-                        x = min_x;
+                    x -= columns.speed[i];
+                    if (x <= columns.minX[i]) {
+                        x = columns.minX[i];
                         movingRight = true;
-                        currentMoveSheetIndex = (currentMoveSheetIndex + 1) % 2;
+                        boss.currentMoveSheetIndex = (boss.currentMoveSheetIndex + 1) % 2;
                     }
                 }
                 frameTimer++;
@@ -228,120 +197,146 @@ struct Boss {
 
         if (attackCooldown > 0) attackCooldown--;
 
-        if (!isDying && health <= 0) {
+        if (!isDying && boss.health <= 0) {
             isHurt = false;
             isDying = true;
             isMoving = false;
             currentFrame = 0;
-            currentDyingSheetIndex = 0;
+            boss.currentDyingSheetIndex = 0;
         }
     }
 
- void render(SDL_Renderer* renderer, float cameraX) {
-    int frameWidth, frameHeight;
-    if (isDying) {
-        frameWidth = 292;
-        frameHeight = 122;
-    } else if (isHurt) {
-        frameWidth = 293;
-        frameHeight = 121;
-    } else if (isAttacking) {
-        frameWidth = 290;
-        frameHeight = 120;
-    } else if (isMoving) {
-        frameWidth = 288;
-        frameHeight = 118;
-    } else {
-        frameWidth = 292;
-        frameHeight = 121;
-    }
+    static void render(const EntityColumns<Boss>& columns, size_t i, SDL_Renderer* renderer, float cameraX) {
+        int frameWidth = frameWidthOf(columns, i);
+        int frameHeight;
+        if (columns.isDying[i]) {
+            frameHeight = 122;
+        } else if (columns.isHurt[i]) {
+            frameHeight = 121;
+        } else if (columns.isAttacking[i]) {
+            frameHeight = 120;
+        } else if (columns.isMoving[i]) {
+            frameHeight = 118;
+        } else {
+            frameHeight = 121;
+        }
 
-    int newWidth = static_cast<int>(frameWidth * scale);
-    int newHeight = static_cast<int>(frameHeight * scale);
-    int renderY = static_cast<int>(y) - newHeight + frameHeight;
+        const Boss& boss = columns.cold[i];
+        int newWidth = static_cast<int>(frameWidth * boss.scale);
+        int newHeight = static_cast<int>(frameHeight * boss.scale);
+        int renderY = static_cast<int>(columns.y[i]) - newHeight + frameHeight;
 
-    float offset = 150.0f;
-    SDL_Rect dstRect = {
-        static_cast<int>(x - cameraX - offset),
-        renderY,
-        newWidth,
-        newHeight
-    };
+        float offset = 150.0f;
+        SDL_Rect dstRect = {
+            static_cast<int>(columns.x[i] - cameraX - offset),
+            renderY,
+            newWidth,
+            newHeight
+        };
 
-    if (dstRect.x + dstRect.w > 0 && dstRect.x < SCREEN_WIDTH) {
-        SDL_Texture* currentTexture = nullptr;
-        if (isDying) {
-            currentTexture = dyingTextures[currentDyingSheetIndex];
-        } else if (isHurt) {
-            currentTexture = hurtTexture;
-        } else if (isAttacking) {
-            currentTexture = attackTextures[currentAttackSheetIndex];
-        } else if (isMoving) {
-            currentTexture = moveTextures[currentMoveSheetIndex];
-        } else {
-            currentTexture = idleTexture;
-        }
+        if (dstRect.x + dstRect.w > 0 && dstRect.x < SCREEN_WIDTH) {
+            TextureHandle currentTexture;
+            if (columns.isDying[i]) {
+                currentTexture = boss.dyingTextures[boss.currentDyingSheetIndex];
+            } else if (columns.isHurt[i]) {
+                currentTexture = boss.hurtTexture;
+            } else if (columns.isAttacking[i]) {
+                currentTexture = boss.attackTextures[boss.currentAttackSheetIndex];
+            } else if (columns.isMoving[i]) {
+                currentTexture = boss.moveTextures[boss.currentMoveSheetIndex];
+            } else {
+                currentTexture = boss.idleTexture;
+            }
 
-        SDL_Rect srcRect = { currentFrame * frameWidth, 0, frameWidth, frameHeight };
-        // Không lật sheet tấn công, chỉ lật sheet di chuyển và idle khi movingRight = true
-        SDL_RendererFlip flip = isAttacking ? SDL_FLIP_NONE : (movingRight ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
+            SDL_Rect srcRect = { columns.currentFrame[i] * frameWidth, 0, frameWidth, frameHeight };
+            // Không lật sheet tấn công, chỉ lật sheet di chuyển và idle khi movingRight = true
+            SDL_RendererFlip flip = columns.isAttacking[i] ? SDL_FLIP_NONE : (columns.movingRight[i] ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
 
-        if (currentTexture) {
-            SDL_RenderCopyEx(renderer, currentTexture, &srcRect, &dstRect, 0, NULL, flip);
+            if (currentTexture.get()) {
+                renderCopy(renderer, currentTexture, &srcRect, &dstRect, flip);
+            } else {
+                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+                SDL_RenderFillRect(renderer, &dstRect);
+            }
+        }
+    }
+
+    static SDL_Rect attackRect(const EntityColumns<Boss>& columns, size_t i) {
+        const Boss& boss = columns.cold[i];
+        int newWidth = static_cast<int>(60 * boss.scale);
+        int newHeight = static_cast<int>(60 * boss.scale);
+        SDL_Rect attackRect = { static_cast<int>(columns.x[i]), static_cast<int>(columns.y[i]), newWidth, newHeight };
+        if (columns.movingRight[i]) {
+            attackRect.x += static_cast<int>(15 * boss.scale);
         } else {
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-            SDL_RenderFillRect(renderer, &dstRect);
+            attackRect.x -= static_cast<int>(60 * boss.scale);
         }
+        return attackRect;
     }
-}
 
-    int getCurrentFrameWidth() const {
-        if (isDying) return 292;
-        else if (isHurt) return 293;
-        else if (isAttacking) return 290;
-        else if (isMoving) return 288;
-        else return 292; // idle
+    static void publishBoxes(const EntityColumns<Boss>& columns, CombatWorld& combat, float cameraX) {
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns.isDying[i] || columns.isHurt[i]) continue;
+            float scale = columns.cold[i].scale;
+            SDL_Rect body = { combatX(columns.x[i], cameraX), static_cast<int>(columns.y[i]), static_cast<int>(288 * scale), static_cast<int>(118 * scale) };
+            combat.addHurtbox(body, FACTION_ENEMY, OWNER_BOSS, i);
+            if (columns.isAttacking[i] && columns.attackCooldown[i] <= 0) {
+                combat.addHitbox(attackRect(columns, i), FACTION_ENEMY, attackDamage, OWNER_BOSS, i);
+            }
+        }
     }
 
-    void renderHealthBar(SDL_Renderer* renderer, float cameraX) {
-    if (isDying || toRemove) return;
-
-    float offset = 150.0f;
-    int frameWidth = getCurrentFrameWidth();
-    int newWidth = static_cast<int>(frameWidth * scale);
-    int dstX = static_cast<int>(x - cameraX - offset);
-
-    // Chỉ hiển thị thanh máu khi boss nằm hoàn toàn hoặc gần hoàn toàn trong màn hình
-    int margin = 100; // Khoảng cách từ mép màn hình (có thể điều chỉnh)
-    if (dstX > -margin && dstX + newWidth < SCREEN_WIDTH + margin) {
-        const int BAR_WIDTH = 1180;
-        const int BAR_HEIGHT = 20;
-        const int BAR_X = (SCREEN_WIDTH - BAR_WIDTH) / 2;
-        const int BAR_Y = SCREEN_HEIGHT - BAR_HEIGHT - 10;
-
-        SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
-        SDL_Rect bgRect = { BAR_X, BAR_Y, BAR_WIDTH, BAR_HEIGHT };
-        SDL_RenderFillRect(renderer, &bgRect);
-
-        int healthWidth = static_cast<int>((static_cast<float>(health) / maxHealth) * BAR_WIDTH);
-        if (healthWidth < 0) healthWidth = 0;
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-        SDL_Rect healthRect = { BAR_X, BAR_Y, healthWidth, BAR_HEIGHT };
-        SDL_RenderFillRect(renderer, &healthRect);
+    static void takeHit(EntityColumns<Boss>& columns, size_t i, int damage) {
+        Boss& boss = columns.cold[i];
+        boss.health -= damage;
+        columns.isHurt[i] = true;
+        columns.currentFrame[i] = 0;
+        std::cout << "Player hit boss, boss health: " << boss.health << std::endl;
     }
-}
-    void cleanup() {
-        for (auto& texture : moveTextures) {
-            if (texture) SDL_DestroyTexture(texture);
-        }
-        for (auto& texture : attackTextures) {
-            if (texture) SDL_DestroyTexture(texture);
-        }
-        for (auto& texture : dyingTextures) {
-            if (texture) SDL_DestroyTexture(texture);
+
+    static int frameWidthOf(const EntityColumns<Boss>& columns, size_t i) {
+        if (columns.isDying[i]) return 292;
+        else if (columns.isHurt[i]) return 293;
+        else if (columns.isAttacking[i]) return 290;
+        else if (columns.isMoving[i]) return 288;
+        else return 292; // idle
+    }
+
+    static void renderHealthBar(const EntityColumns<Boss>& columns, size_t i, SDL_Renderer* renderer, float cameraX) {
+        if (columns.isDying[i] || columns.toRemove[i]) return;
+
+        const Boss& boss = columns.cold[i];
+        float offset = 150.0f;
+        int frameWidth = frameWidthOf(columns, i);
+        int newWidth = static_cast<int>(frameWidth * boss.scale);
+        int dstX = static_cast<int>(columns.x[i] - cameraX - offset);
+
+        // Chỉ hiển thị thanh máu khi boss nằm hoàn toàn hoặc gần hoàn toàn trong màn hình
+        int margin = 100; // Khoảng cách từ mép màn hình (có thể điều chỉnh)
+        if (dstX > -margin && dstX + newWidth < SCREEN_WIDTH + margin) {
+            const int BAR_WIDTH = 1180;
+            const int BAR_HEIGHT = 20;
+            const int BAR_X = (SCREEN_WIDTH - BAR_WIDTH) / 2;
+            const int BAR_Y = SCREEN_HEIGHT - BAR_HEIGHT - 10;
+
+            SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
+            SDL_Rect bgRect = { BAR_X, BAR_Y, BAR_WIDTH, BAR_HEIGHT };
+            SDL_RenderFillRect(renderer, &bgRect);
+
+            int healthWidth = static_cast<int>((static_cast<float>(boss.health) / boss.maxHealth) * BAR_WIDTH);
+            if (healthWidth < 0) healthWidth = 0;
+            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+            SDL_Rect healthRect = { BAR_X, BAR_Y, healthWidth, BAR_HEIGHT };
+            SDL_RenderFillRect(renderer, &healthRect);
         }
-        if (hurtTexture) SDL_DestroyTexture(hurtTexture);
-        if (idleTexture) SDL_DestroyTexture(idleTexture);
+    }
+
+    void cleanup(TextureManager& textureManager) {
+        for (auto& texture : moveTextures) textureManager.release(texture);
+        for (auto& texture : attackTextures) textureManager.release(texture);
+        for (auto& texture : dyingTextures) textureManager.release(texture);
+        textureManager.release(hurtTexture);
+        textureManager.release(idleTexture);
     }
 };
 
@@ -1,22 +1,23 @@
 struct Bullet {
     float x, y;
+    float previousX, previousY;
     float velocityX;
     bool toRemove;
     int width, height;
-    SDL_Texture* bulletTexture;
+    TextureHandle bulletTexture;
+    EntityHandle owner;   // Enemy đã bắn, resolveCombat tra qua rowOf(owner) để ghi nhận đòn trúng; < 0 khi Enemy đó không còn
 
-    void init(SDL_Renderer* renderer, float startX, float startY, bool movingRight) {
+    void init(TextureHandle texture, float startX, float startY, bool movingRight) {
         x = startX + (movingRight ? 64 : -48);
         y = startY + 16;
+        previousX = x;
+        previousY = y;
         velocityX = movingRight ? 5.0f : -5.0f;
         toRemove = false;
         width = 36;
         height = 18;
+        bulletTexture = texture;
 
-        bulletTexture = IMG_LoadTexture(renderer, "bullet.png");
-        if (!bulletTexture) {
-            std::cerr << "❌ Không tải được bullet.png: " << IMG_GetError() << std::endl;
-        }
         if (debugBullet) {
             std::cout << "Bullet initialized at x: " << x << ", y: " << y << std::endl;
         }
@@ -24,7 +25,7 @@ struct Bullet {
 
     void update() {
         x += velocityX;
-        if (x < -width || x > MAP_WIDTH * TILE_WIDTH + width) {
+        if (x < -width || x > levelWidthPixels + width) {
             toRemove = true;
         }
         if (debugBullet && toRemove) {
@@ -38,18 +39,68 @@ struct Bullet {
         if (debugBullet && renderX + width > 0 && renderX < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
             std::cout << "Bullet rendered at x: " << renderX << ", y: " << y << std::endl;
         }
-        if (bulletTexture) {
-            SDL_RenderCopy(renderer, bulletTexture, NULL, &dstRect);
+        if (bulletTexture.get()) {
+            renderCopy(renderer, bulletTexture, NULL, &dstRect);
         } else {
             SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
             SDL_RenderFillRect(renderer, &dstRect);
         }
     }
+};
+
+const int BULLET_POOL_CAPACITY = 256;
+
+// Pool cố định cho đạn: bắn không cấp phát bộ nhớ, không đọc file, dùng chung một texture
+struct BulletPool {
+    Bullet bullets[BULLET_POOL_CAPACITY];
+    int nextFree[BULLET_POOL_CAPACITY];
+    int freeHead;
+    int usedSlots;
+    TextureHandle texture;
+    int liveCount;
+    int peakCount;
+    int recycledCount;
 
-    void cleanup() {
-        if (bulletTexture) {
-            SDL_DestroyTexture(bulletTexture);
-            bulletTexture = nullptr;
+    void init(TextureManager& textureManager) {
+        for (int i = 0; i < BULLET_POOL_CAPACITY; i++) {
+            nextFree[i] = i + 1 < BULLET_POOL_CAPACITY ? i + 1 : -1;
         }
+        freeHead = 0;
+        usedSlots = 0;
+        liveCount = 0;
+        peakCount = 0;
+        recycledCount = 0;
+        texture = textureManager.acquire(ASSETS_PATH + "bullet.png");
+    }
+
+    // Trả về chỉ số slot, hoặc -1 khi pool đã đầy
+    int acquire(float startX, float startY, bool movingRight) {
+        if (freeHead == -1) return -1;
+        int index = freeHead;
+        freeHead = nextFree[index];
+        // Slot mới luôn được lấy theo thứ tự tăng dần, nên slot nhỏ hơn usedSlots là slot tái sử dụng
+        if (index < usedSlots) recycledCount++;
+        else usedSlots = index + 1;
+        liveCount++;
+        if (liveCount > peakCount) peakCount = liveCount;
+        bullets[index].init(texture, startX, startY, movingRight);
+        return index;
+    }
+
+    void release(int index) {
+        nextFree[index] = freeHead;
+        freeHead = index;
+        liveCount--;
+    }
+
+    Bullet& get(int index) { return bullets[index]; }
+
+    void printStats() const {
+        std::cout << "BulletPool: live=" << liveCount << ", peak=" << peakCount
+                  << ", recycled=" << recycledCount << ", capacity=" << BULLET_POOL_CAPACITY << std::endl;
+    }
+
+    void cleanup(TextureManager& textureManager) {
+        textureManager.release(texture);
     }
 };
@@ -0,0 +1,155 @@
+// Định dạng assets.bundle do tools/bundler sinh ra:
+//   BundleHeader | dữ liệu (mỗi khối căn 16 byte) | bảng băm BundleEntry[indexCapacity]
+// Ảnh được lưu sẵn ở dạng pixel của renderer nên chỉ cần SDL_UpdateTexture, không phải giải mã PNG.
+const uint32_t BUNDLE_VERSION = 1;
+const uint32_t BUNDLE_KIND_RAW = 0;
+const uint32_t BUNDLE_KIND_PIXELS = 1;
+const int BUNDLE_NAME_SIZE = 48;
+
+struct BundleHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t pixelFormat;
+    uint32_t entryCount;
+    uint32_t indexCapacity;
+    uint32_t reserved;
+    uint64_t indexOffset;
+};
+
+struct BundleEntry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    int64_t sourceTime;
+    uint64_t sourceSize;
+    uint32_t kind;
+    int32_t width;
+    int32_t height;
+    int32_t pitch;
+    char name[BUNDLE_NAME_SIZE];
+};
+
+uint64_t bundleHash(const std::string& name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash ? hash : 1;
+}
+
+struct AssetBundle {
+    MappedFile file;
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    const BundleHeader* header = nullptr;
+    const BundleEntry* index = nullptr;
+
+    // Bundle sai phiên bản, hỏng, hoặc cũ hơn file nguồn trong assets/ đều bị bỏ qua
+    bool open(const std::string& path) {
+        if (!file.map(path)) return false;
+        base = file.base;
+        size = file.size;
+
+        header = reinterpret_cast<const BundleHeader*>(base);
+        if (size < sizeof(BundleHeader) || std::memcmp(header->magic, "HBDL", 4) != 0) {
+            std::cerr << "❌ " << path << " không phải asset bundle" << std::endl;
+            close();
+            return false;
+        }
+        if (header->version != BUNDLE_VERSION) {
+            std::cerr << "❌ " << path << " có phiên bản " << header->version << ", cần " << BUNDLE_VERSION << std::endl;
+            close();
+            return false;
+        }
+        // Bảng băm phải có kích thước luỹ thừa của 2 và còn ít nhất một ô trống, nếu không find() đọc
+        // tràn hoặc dò mãi không dừng
+        uint32_t capacity = header->indexCapacity;
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0 || capacity <= header->entryCount) {
+            std::cerr << "❌ " << path << " có bảng chỉ mục hỏng" << std::endl;
+            close();
+            return false;
+        }
+        if (header->indexOffset > size || header->indexOffset % alignof(BundleEntry) != 0 ||
+            capacity > (size - header->indexOffset) / sizeof(BundleEntry)) {
+            std::cerr << "❌ " << path << " bị cắt cụt" << std::endl;
+            close();
+            return false;
+        }
+        index = reinterpret_cast<const BundleEntry*>(base + header->indexOffset);
+
+        uint32_t used = 0;
+        for (uint32_t i = 0; i < capacity; i++) {
+            const BundleEntry& entry = index[i];
+            if (!entry.hash) continue;
+            used++;
+            if (used >= capacity || std::memchr(entry.name, '\0', BUNDLE_NAME_SIZE) == nullptr) {
+                std::cerr << "❌ " << path << " có bảng chỉ mục hỏng" << std::endl;
+                close();
+                return false;
+            }
+            if (entry.offset > size || entry.size > size - entry.offset) {
+                std::cerr << "❌ " << path << " bị cắt cụt" << std::endl;
+                close();
+                return false;
+            }
+            // Kích thước được đưa thẳng cho SDL_CreateTexture/SDL_UpdateTexture
+            if (entry.kind == BUNDLE_KIND_PIXELS &&
+                (entry.width <= 0 || entry.height <= 0 ||
+                 static_cast<int64_t>(entry.width) * SDL_BYTESPERPIXEL(header->pixelFormat) > entry.pitch ||
+                 entry.size < static_cast<uint64_t>(entry.pitch) * static_cast<uint64_t>(entry.height))) {
+                std::cerr << "❌ " << path << " có ảnh " << entry.name << " sai kích thước" << std::endl;
+                close();
+                return false;
+            }
+            struct stat info;
+            std::string source = ASSETS_PATH + entry.name;
+            if (stat(source.c_str(), &info) == 0 &&
+                (static_cast<int64_t>(info.st_mtime) > entry.sourceTime || static_cast<uint64_t>(info.st_size) != entry.sourceSize)) {
+                std::cerr << "❌ " << path << " đã cũ (" << entry.name << " đã thay đổi), hãy chạy lại bundler" << std::endl;
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    const BundleEntry* find(const std::string& name) const {
+        if (!base || name.size() >= BUNDLE_NAME_SIZE) return nullptr;
+        uint64_t hash = bundleHash(name);
+        uint32_t mask = header->indexCapacity - 1;
+        for (uint32_t i = static_cast<uint32_t>(hash) & mask; index[i].hash; i = (i + 1) & mask) {
+            if (index[i].hash == hash && name == index[i].name) return &index[i];
+        }
+        return nullptr;
+    }
+
+    // Tra cứu theo đường dẫn đầy đủ "assets/..." như phần còn lại của game
+    const BundleEntry* findPath(const std::string& path) const {
+        if (path.compare(0, ASSETS_PATH.size(), ASSETS_PATH) != 0) return nullptr;
+        return find(path.substr(ASSETS_PATH.size()));
+    }
+
+    const uint8_t* data(const BundleEntry& entry) const { return base + entry.offset; }
+
+    void close() {
+        file.unmap();
+        base = nullptr;
+        header = nullptr;
+        index = nullptr;
+        size = 0;
+    }
+};
+
+AssetBundle assetBundle;
+
+// Mở file tài nguyên (font, nhạc) từ bundle nếu có, nếu không thì từ đĩa
+SDL_RWops* openAsset(const std::string& path) {
+    const BundleEntry* entry = assetBundle.findPath(path);
+    if (entry && entry->kind == BUNDLE_KIND_RAW) {
+        return SDL_RWFromConstMem(assetBundle.data(*entry), static_cast<int>(entry->size));
+    }
+    return SDL_RWFromFile(path.c_str(), "rb");
+}
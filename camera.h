@@ -2,18 +2,24 @@
 struct Camera {
     float x;
     float y;
+    float previousX;   // Vị trí ở tick trước, để nội suy khi vẽ
+    float previousY;
     int mapWidthPixels;
     bool isShaking;       // Trạng thái rung
     int shakeTimer;       // Thời gian rung
     int shakeIntensity;   // Độ mạnh của rung
+    int shakeClock;       // Số lần update, thay cho SDL_GetTicks để rung giống hệt khi phát lại
 
     void init(int mapWidth) {
         x = 0;
         y = 0;
+        previousX = 0;
+        previousY = 0;
         mapWidthPixels = mapWidth * TILE_WIDTH;
         isShaking = false;
         shakeTimer = 0;
         shakeIntensity = 0;
+        shakeClock = 0;
     }
 
     void update(float playerX) {
@@ -21,10 +27,12 @@ struct Camera {
         if (x < 0) x = 0;
         if (x > mapWidthPixels - SCREEN_WIDTH) x = mapWidthPixels - SCREEN_WIDTH;
 
+        shakeClock++;
         if (isShaking && shakeTimer > 0) {
             float shakeProgress = static_cast<float>(shakeTimer) / 10.0f;
-            x += sin(SDL_GetTicks() * 0.1f) * shakeIntensity * shakeProgress;
-            y += cos(SDL_GetTicks() * 0.1f) * shakeIntensity * shakeProgress;
+            float shakeMillis = shakeClock * 16.0f;
+            x += sin(shakeMillis * 0.1f) * shakeIntensity * shakeProgress;
+            y += cos(shakeMillis * 0.1f) * shakeIntensity * shakeProgress;
             shakeTimer--;
             if (shakeTimer <= 0) {
                 isShaking = false;
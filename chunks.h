@@ -0,0 +1,220 @@
+const int CHUNK_PIXELS = CHUNK_COLUMNS * TILE_WIDTH;
+const int CHUNK_MARGIN = SCREEN_WIDTH / 2;   // Nạp trước nửa màn hình mỗi bên để không thấy chunk xuất hiện
+
+struct LevelChunk {
+    int index;
+    std::vector<Platform> platforms;
+    std::vector<Door> doors;
+    SDL_Texture* baked;   // Nền tảng và cửa của chunk đã vẽ sẵn, nullptr nếu vẽ từng dải
+};
+
+// Chỉ giữ các chunk cột quanh camera; bộ nhớ không phụ thuộc chiều rộng level.
+// Ô được đọc thẳng từ level đã pack (mmap/bundle) nên nạp một chunk chỉ là giải mã vài trăm ô.
+struct ChunkStreamer {
+    const LevelData* level;
+    SDL_Renderer* renderer;
+    TextureManager* textureManager;
+    std::deque<LevelChunk> chunks;    // Các chunk liên tiếp, bắt đầu từ firstChunk
+    int firstChunk;
+    std::vector<Platform> platforms;  // Nền tảng của mọi chunk đang nạp, dựng lại khi cửa sổ chunk đổi
+    bool bakeEnabled;
+    SDL_BlendMode bakedBlendMode;
+    int loads;
+    int unloads;
+    int peakChunks;
+    int bakes;
+
+    void init(SDL_Renderer* renderer, const LevelData& level, TextureManager& textureManager) {
+        cleanup();
+        this->level = &level;
+        this->renderer = renderer;
+        this->textureManager = &textureManager;
+        firstChunk = 0;
+        loads = 0;
+        unloads = 0;
+        peakChunks = 0;
+        bakes = 0;
+        bakeEnabled = renderer && bakeStaticLayer && SDL_RenderTargetSupported(renderer);
+        // Texture bake chứa màu đã nhân alpha nên phải trộn kiểu premultiplied; kết quả giống vẽ trực tiếp
+        // tới mức làm tròn 8 bit ở các mép ô nửa trong suốt
+        bakedBlendMode = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                                    SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    }
+
+    int chunkCount() const {
+        return (level->width + CHUNK_COLUMNS - 1) / CHUNK_COLUMNS;
+    }
+
+    LevelChunk loadChunk(int index) {
+        LevelChunk chunk;
+        chunk.index = index;
+        int endCol = std::min(level->width, (index + 1) * CHUNK_COLUMNS);
+        // Gộp các ô cùng loại liền nhau trên một hàng thành một dải (không vượt qua biên chunk)
+        for (int row = 0; row < level->height; row++) {
+            int col = index * CHUNK_COLUMNS;
+            while (col < endCol) {
+                int value = level->tile(row, col);
+                int start = col++;
+                if (!isPlatformTile(value)) continue;
+                while (col < endCol && level->tile(row, col) == value) col++;
+                Platform platform;
+                platform.init(renderer, start * TILE_WIDTH, row * TILE_HEIGHT, value, col - start, *textureManager);
+                chunk.platforms.push_back(platform);
+            }
+        }
+        for (const auto& point : level->doors) {
+            if (point.x / CHUNK_PIXELS != index) continue;
+            Door door;
+            door.init(renderer, point.x, point.y, *textureManager);
+            chunk.doors.push_back(door);
+        }
+        chunk.baked = nullptr;
+        if (bakeEnabled) bake(chunk);
+        loads++;
+        return chunk;
+    }
+
+    void renderChunk(LevelChunk& chunk, float cameraX) {
+        for (auto& door : chunk.doors) door.render(renderer, cameraX);
+        for (auto& platform : chunk.platforms) platform.render(renderer, cameraX);
+    }
+
+    // Vẽ chunk một lần vào texture TARGET rộng đúng một màn hình; vẽ lại chỉ khi nạp chunk hoặc mất render target
+    void bake(LevelChunk& chunk) {
+        if (!chunk.baked) {
+            chunk.baked = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                            CHUNK_PIXELS, level->height * TILE_HEIGHT);
+            if (!chunk.baked) {
+                std::cerr << "❌ Không tạo được texture cho chunk " << chunk.index << ": " << SDL_GetError() << std::endl;
+                return;
+            }
+            // Renderer không hỗ trợ blend mode tuỳ biến (vd. software) sẽ để texture ở BLENDMODE_NONE và
+            // phần trong suốt thành màu đen: quay về vẽ từng dải cho cả level
+            if (SDL_SetTextureBlendMode(chunk.baked, bakedBlendMode) != 0) {
+                std::cerr << "❌ Renderer không hỗ trợ blend mode của chunk bake, vẽ từng dải: " << SDL_GetError() << std::endl;
+                SDL_DestroyTexture(chunk.baked);
+                chunk.baked = nullptr;
+                bakeEnabled = false;
+                return;
+            }
+        }
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, chunk.baked);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        renderChunk(chunk, static_cast<float>(chunk.index * CHUNK_PIXELS));
+        SDL_SetRenderTarget(renderer, previousTarget);
+        renderStats.lastTexture = nullptr;
+        bakes++;
+    }
+
+    void unloadChunk(LevelChunk& chunk) {
+        for (auto& platform : chunk.platforms) platform.cleanup();
+        for (auto& door : chunk.doors) door.cleanup();
+        if (chunk.baked) SDL_DestroyTexture(chunk.baked);
+        chunk.baked = nullptr;
+        unloads++;
+    }
+
+    // SDL_RENDER_TARGETS_RESET / SDL_RENDER_DEVICE_RESET: nội dung texture TARGET đã mất
+    void rebake() {
+        if (!bakeEnabled) return;
+        for (auto& chunk : chunks) bake(chunk);
+    }
+
+    // Lớp tĩnh (nền tảng + cửa): tối đa hai texture đã bake mỗi frame vì mỗi chunk rộng một màn hình
+    void render(float cameraX) {
+        PROFILE_SCOPE("ChunkStreamer::render");
+        int cameraLeft = static_cast<int>(cameraX);
+        for (auto& chunk : chunks) {
+            int left = chunk.index * CHUNK_PIXELS - cameraLeft;
+            if (left + CHUNK_PIXELS <= 0 || left >= SCREEN_WIDTH) continue;
+            if (!chunk.baked) {
+                renderChunk(chunk, cameraX);
+                continue;
+            }
+            SDL_Rect dstRect = { left, 0, CHUNK_PIXELS, level->height * TILE_HEIGHT };
+            if (chunk.baked != renderStats.lastTexture) {
+                renderStats.textureSwitches++;
+                renderStats.lastTexture = chunk.baked;
+            }
+            renderStats.copies++;
+            SDL_RenderCopy(renderer, chunk.baked, NULL, &dstRect);
+        }
+    }
+
+    void update(float cameraX) {
+        if (!renderer) return;   // Headless: va chạm đọc thẳng lưới ô, chunk chỉ phục vụ việc vẽ
+        int first = std::max(0, static_cast<int>(std::floor((cameraX - CHUNK_MARGIN) / CHUNK_PIXELS)));
+        int last = std::min(chunkCount() - 1, static_cast<int>(std::floor((cameraX + SCREEN_WIDTH + CHUNK_MARGIN) / CHUNK_PIXELS)));
+        bool changed = false;
+
+        // Camera nhảy xa (hồi sinh, đổi level): bỏ hết rồi nạp lại
+        if (!chunks.empty() && (first > chunks.back().index || last < firstChunk)) {
+            for (auto& chunk : chunks) unloadChunk(chunk);
+            chunks.clear();
+        }
+        if (chunks.empty()) {
+            firstChunk = first;
+            for (int i = first; i <= last; i++) chunks.push_back(loadChunk(i));
+            changed = true;
+        }
+        while (firstChunk < first) {
+            unloadChunk(chunks.front());
+            chunks.pop_front();
+            firstChunk++;
+            changed = true;
+        }
+        while (firstChunk + static_cast<int>(chunks.size()) - 1 > last) {
+            unloadChunk(chunks.back());
+            chunks.pop_back();
+            changed = true;
+        }
+        while (firstChunk > first) {
+            firstChunk--;
+            chunks.push_front(loadChunk(firstChunk));
+            changed = true;
+        }
+        while (firstChunk + static_cast<int>(chunks.size()) - 1 < last) {
+            chunks.push_back(loadChunk(firstChunk + static_cast<int>(chunks.size())));
+            changed = true;
+        }
+
+        if (changed) {
+            collectPlatforms();
+            peakChunks = std::max(peakChunks, static_cast<int>(chunks.size()));
+        }
+    }
+
+    void collectPlatforms() {
+        platforms.clear();
+        for (const auto& chunk : chunks) {
+            platforms.insert(platforms.end(), chunk.platforms.begin(), chunk.platforms.end());
+        }
+    }
+
+    // Level vừa bị sửa tại chỗ: chỉ dựng (và bake) lại các chunk đang giữ có cột trong [firstColumn, lastColumn]
+    int reloadColumns(int firstColumn, int lastColumn) {
+        int reloaded = 0;
+        for (auto& chunk : chunks) {
+            if ((chunk.index + 1) * CHUNK_COLUMNS <= firstColumn || chunk.index * CHUNK_COLUMNS > lastColumn) continue;
+            unloadChunk(chunk);
+            chunk = loadChunk(chunk.index);
+            reloaded++;
+        }
+        if (reloaded > 0) collectPlatforms();
+        return reloaded;
+    }
+
+    void printStats() const {
+        std::cout << "Chunks: " << chunks.size() << " resident (peak " << peakChunks << ") of " << chunkCount()
+                  << ", loads=" << loads << ", unloads=" << unloads << ", bakes=" << bakes << ", "
+                  << platforms.size() << " platform spans" << std::endl;
+    }
+
+    void cleanup() {
+        for (auto& chunk : chunks) unloadChunk(chunk);
+        chunks.clear();
+        platforms.clear();
+    }
+};
@@ -0,0 +1,103 @@
+// Tra cứu va chạm trực tiếp trên lưới ô của level: chi phí tỉ lệ với số ô mà hộp chạm vào,
+// không phụ thuộc tổng số nền tảng trong level.
+struct CollisionGrid {
+    const LevelData* level = nullptr;
+
+    void init(const LevelData& level) {
+        this->level = &level;
+    }
+
+    bool isSolid(int row, int col) const {
+        if (!level || row < 0 || row >= level->height || col < 0 || col >= level->width) return false;
+        return isPlatformTile(level->tile(row, col));
+    }
+
+    SDL_Rect tileRect(int row, int col) const {
+        return { col * TILE_WIDTH, row * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT };
+    }
+
+    static int floorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // Các ô rắn giao với box (cùng quy tắc với SDL_HasIntersection), theo thứ tự hàng rồi cột
+    int query(const SDL_Rect& box, SDL_Rect* hits, int maxHits) const {
+        if (box.w <= 0 || box.h <= 0) return 0;
+        int firstCol = std::max(0, floorDiv(box.x, TILE_WIDTH));
+        int lastCol = std::min(level->width - 1, floorDiv(box.x + box.w - 1, TILE_WIDTH));
+        int firstRow = std::max(0, floorDiv(box.y, TILE_HEIGHT));
+        int lastRow = std::min(level->height - 1, floorDiv(box.y + box.h - 1, TILE_HEIGHT));
+        int count = 0;
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int col = firstCol; col <= lastCol; col++) {
+                if (!isSolid(row, col)) continue;
+                if (count < maxHits) hits[count] = tileRect(row, col);
+                count++;
+            }
+        }
+        return std::min(count, maxHits);
+    }
+
+    // Ô rắn cao nhất có đỉnh..đáy chứa chân (feetY) và chồng ngang với [left, left + width)
+    bool findGround(int left, int width, float feetY, SDL_Rect& ground) const {
+        if (width <= 0 || feetY < 0) return false;
+        int firstCol = std::max(0, floorDiv(left, TILE_WIDTH));
+        int lastCol = std::min(level->width - 1, floorDiv(left + width - 1, TILE_WIDTH));
+        int row = static_cast<int>(feetY) / TILE_HEIGHT;
+        // Chân nằm đúng trên ranh giới hai hàng thì cả ô phía trên cũng chứa nó
+        int firstRow = feetY == row * TILE_HEIGHT ? row - 1 : row;
+        for (int r = std::max(0, firstRow); r <= row && r < level->height; r++) {
+            for (int col = firstCol; col <= lastCol; col++) {
+                if (isSolid(r, col)) {
+                    ground = tileRect(r, col);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Hàng của ô rắn cao nhất trong cột, level->height nếu cột không có ô rắn
+    int topSolidRow(int col) const {
+        for (int row = 0; row < level->height; row++) {
+            if (isSolid(row, col)) return row;
+        }
+        return level->height;
+    }
+
+    // Ô rắn cao nhất trong cột gần x nhất (tính theo tâm ô). Giữ đúng thứ tự của cách quét danh sách
+    // nền tảng theo hàng rồi cột trước đây: hai cột cách đều thì ô ở hàng cao hơn thắng, cùng hàng thì
+    // cột bên trái thắng
+    bool findNearestGround(float x, SDL_Rect& ground) const {
+        if (!level || level->width == 0) return false;
+        auto distanceTo = [x](int col) { return std::abs(col * TILE_WIDTH + TILE_WIDTH / 2.0f - x); };
+        // left: cột cuối cùng có tâm <= x, right: cột đầu tiên có tâm > x
+        float split = std::floor((x - TILE_WIDTH / 2.0f) / TILE_WIDTH);
+        int left = static_cast<int>(std::max(-1.0f, std::min(level->width - 1.0f, split)));
+        int right = left + 1;
+        while (left >= 0 || right < level->width) {
+            float leftDistance = left >= 0 ? distanceTo(left) : INFINITY;
+            float rightDistance = right < level->width ? distanceTo(right) : INFINITY;
+            int bestRow = level->height;
+            int bestCol = -1;
+            // Cột gần hơn ở mỗi phía; cách đều thì xét cả hai, bên trái trước
+            if (leftDistance <= rightDistance) {
+                bestRow = topSolidRow(left);
+                bestCol = left--;
+            }
+            if (rightDistance <= leftDistance) {
+                int row = topSolidRow(right);
+                if (row < bestRow) {
+                    bestRow = row;
+                    bestCol = right;
+                }
+                right++;
+            }
+            if (bestRow < level->height) {
+                ground = tileRect(bestRow, bestCol);
+                return true;
+            }
+        }
+        return false;
+    }
+};
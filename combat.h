@@ -0,0 +1,117 @@
+// Va chạm chiến đấu: mỗi thực thể đăng ký hurtbox (chỗ bị đánh) và hitbox (đòn đánh, kèm phe và
+// sát thương). Sweep-and-prune trên trục x tìm các cặp chồng nhau trong một lượt, thay cho từng
+// vòng lặp riêng cho mỗi cặp loại.
+const int PLAYER_ATTACK_DAMAGE = 5;   // Trừ vào máu boss; Enemy/NewEnemy thì đếm số đòn
+const int BULLET_DAMAGE = 10;
+
+enum CombatFaction : uint8_t {
+    FACTION_PLAYER,
+    FACTION_ENEMY
+};
+
+enum CombatOwner : uint8_t {
+    OWNER_PLAYER,
+    OWNER_ENEMY,
+    OWNER_NEW_ENEMY,
+    OWNER_NEW_ENEMY5,
+    OWNER_BOSS,
+    OWNER_BULLET
+};
+
+const char* const COMBAT_OWNER_NAMES[] = { "Player", "Enemy", "NewEnemy", "NewEnemy5", "Boss", "Bullet" };
+
+struct CombatBox {
+    SDL_Rect rect;
+    int damage;        // 0 với hurtbox
+    uint32_t index;    // Hàng trong bảng của loại owner, hoặc slot đạn
+    uint8_t faction;
+    uint8_t owner;
+    bool isHitbox;
+};
+
+struct CombatContact {
+    uint32_t hitbox;
+    uint32_t hurtbox;
+};
+
+// Hurtbox kẻ địch trước đây được so trong toạ độ màn hình (x - camera). Làm tròn theo cách đó rồi
+// cộng lại phần nguyên của camera: mọi box cùng ở toạ độ thế giới mà kết quả va chạm không đổi.
+int combatX(float x, float cameraX) {
+    return static_cast<int>(x - cameraX) + static_cast<int>(cameraX);
+}
+
+struct CombatWorld {
+    std::vector<CombatBox> boxes;
+    std::vector<uint32_t> sorted;
+    std::vector<uint32_t> active;
+    std::vector<CombatContact> contacts;
+    long long ticks = 0;
+    long long totalBoxes = 0;
+    long long totalTests = 0;
+    long long totalBruteForce = 0;
+    long long totalContacts = 0;
+
+    void clear() {
+        boxes.clear();
+        contacts.clear();
+    }
+
+    // Thứ tự đăng ký quyết định thứ tự xử lý: cặp được sắp theo (hitbox, hurtbox)
+    void addHitbox(const SDL_Rect& rect, CombatFaction faction, int damage, CombatOwner owner, size_t index) {
+        if (rect.w <= 0 || rect.h <= 0) return;
+        boxes.push_back({ rect, damage, static_cast<uint32_t>(index), faction, owner, true });
+    }
+
+    void addHurtbox(const SDL_Rect& rect, CombatFaction faction, CombatOwner owner, size_t index) {
+        if (rect.w <= 0 || rect.h <= 0) return;
+        boxes.push_back({ rect, 0, static_cast<uint32_t>(index), faction, owner, false });
+    }
+
+    // Duyệt box theo mép trái tăng dần; danh sách active giữ các box mà mép phải còn vượt qua
+    // mép trái hiện tại. Chỉ cặp hitbox-hurtbox khác phe và chồng nhau theo y mới thành contact.
+    const std::vector<CombatContact>& findContacts() {
+        PROFILE_SCOPE("CombatWorld::findContacts");
+        contacts.clear();
+        sorted.resize(boxes.size());
+        for (size_t i = 0; i < boxes.size(); i++) sorted[i] = static_cast<uint32_t>(i);
+        std::sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b) {
+            return boxes[a].rect.x < boxes[b].rect.x;
+        });
+
+        size_t hitboxes = 0;
+        active.clear();
+        for (uint32_t current : sorted) {
+            const CombatBox& box = boxes[current];
+            if (box.isHitbox) hitboxes++;
+            size_t kept = 0;
+            for (uint32_t other : active) {
+                const CombatBox& candidate = boxes[other];
+                if (candidate.rect.x + candidate.rect.w <= box.rect.x) continue;
+                active[kept++] = other;
+                totalTests++;
+                if (candidate.isHitbox == box.isHitbox || candidate.faction == box.faction) continue;
+                if (candidate.rect.y >= box.rect.y + box.rect.h || box.rect.y >= candidate.rect.y + candidate.rect.h) continue;
+                if (box.isHitbox) contacts.push_back({ current, other });
+                else contacts.push_back({ other, current });
+            }
+            active.resize(kept);
+            active.push_back(current);
+        }
+        std::sort(contacts.begin(), contacts.end(), [](const CombatContact& a, const CombatContact& b) {
+            return a.hitbox != b.hitbox ? a.hitbox < b.hitbox : a.hurtbox < b.hurtbox;
+        });
+
+        ticks++;
+        totalBoxes += boxes.size();
+        totalBruteForce += static_cast<long long>(hitboxes) * (boxes.size() - hitboxes);
+        totalContacts += contacts.size();
+        return contacts;
+    }
+
+    void printStats() const {
+        if (ticks == 0) return;
+        std::cout << "Combat: " << static_cast<double>(totalBoxes) / ticks << " boxes/tick, "
+                  << static_cast<double>(totalTests) / ticks << " pair tests/tick (brute force "
+                  << static_cast<double>(totalBruteForce) / ticks << "), " << totalContacts << " contacts" << std::endl;
+    }
+};
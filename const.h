@@ -5,10 +5,24 @@ const float JUMP_STRENGTH = -8.3f;
 bool isGameStarted = false;
 bool musicStarted = false;
 bool debugBullet = false;
+bool bakeStaticLayer = true;
 
 const int TILE_WIDTH = 59;
 const int TILE_HEIGHT = 68;
-const int MAP_HEIGHT = 11;
-const int MAP_WIDTH = 160;
+int levelWidthPixels = 0;
+
+// RNG của gameplay (xorshift32): seed được ghi vào file replay để phát lại y hệt
+uint32_t randomState = 1;
+
+void seedRandom(uint32_t seed) {
+    randomState = seed ? seed : 1;
+}
+
+uint32_t nextRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
 
 const std::string ASSETS_PATH = "assets/";
@@ -1,182 +1,211 @@
-struct Enemy {
-    float x, y;
-    float speed;
-    bool movingRight;
-    float min_x, max_x;
-    SDL_Texture* texture;
-    SDL_Texture* attackTexture;
-    SDL_Texture* hurtTexture;
-    SDL_Texture* dyingTexture;
-    int currentFrame;
-    int frameCount;
-    int attackFrameCount;
-    int hurtFrameCount;
-    int dyingFrameCount;
-    int frameDelay;
-    int attackFrameDelay;
-    int hurtFrameDelay;
-    int dyingFrameDelay;
-    int frameTimer;
-    bool isAttacking;
-    bool isHurt;
-    bool isDying;
-    bool toRemove;
-    int hitCount;
-    std::vector<Bullet> bullets;
-    int shootTimer;
-    int shootDelay;
-    int attackCooldown;
-    int attackCooldownMax;
-
-    void init(SDL_Renderer* renderer, float start_x, float start_y, float min_x, float max_x) {
-        x = start_x;
-        y = start_y;
-        speed = 1.2f;
-        movingRight = true;
-        this->min_x = min_x;
-        this->max_x = max_x;
-
-        std::string imagePath = ASSETS_PATH + "enemy_sheet.png";
-        SDL_Surface* surface = IMG_Load(imagePath.c_str());
-        texture = surface ? SDL_CreateTextureFromSurface(renderer, surface) : nullptr;
-        if (!surface) std::cerr << "❌ Không tải được " << imagePath << ": " << IMG_GetError() << std::endl;
-        if (surface) SDL_FreeSurface(surface);
+const int MAX_ENEMY_BULLETS = 10;
 
-        std::string attackPath = ASSETS_PATH + "enemy_attack_sheet.png";
-        SDL_Surface* attackSurface = IMG_Load(attackPath.c_str());
-        attackTexture = attackSurface ? SDL_CreateTextureFromSurface(renderer, attackSurface) : nullptr;
-        if (!attackSurface) std::cerr << "❌ Không tải được " << attackPath << ": " << IMG_GetError() << std::endl;
-        if (attackSurface) SDL_FreeSurface(attackSurface);
+// Kẻ địch bắn đạn. Trạng thái nóng nằm trong EntityColumns<Enemy>, struct này chỉ là phần cold.
+struct Enemy {
+    static constexpr int frameCount = 4;
+    static constexpr int attackFrameCount = 8;
+    static constexpr int hurtFrameCount = 4;
+    static constexpr int dyingFrameCount = 6;
+    static constexpr int frameDelay = 8;
+    static constexpr int attackFrameDelay = 6;
+    static constexpr int hurtFrameDelay = 4;
+    static constexpr int dyingFrameDelay = 4;
+    static constexpr int shootDelay = 1;
+    static constexpr int attackCooldownMax = 60;
+    static constexpr int attackDamage = 15;
+    static constexpr int hitsToDie = 2;
 
-        std::string hurtPath = ASSETS_PATH + "enemy_hurt_sheet.png";
-        SDL_Surface* hurtSurface = IMG_Load(hurtPath.c_str());
-        hurtTexture = hurtSurface ? SDL_CreateTextureFromSurface(renderer, hurtSurface) : nullptr;
-        if (!hurtSurface) std::cerr << "❌ Không tải được " << hurtPath << ": " << IMG_GetError() << std::endl;
-        if (hurtSurface) SDL_FreeSurface(hurtSurface);
+    TextureHandle texture;
+    TextureHandle attackTexture;
+    TextureHandle hurtTexture;
+    TextureHandle dyingTexture;
+    int bulletSlots[MAX_ENEMY_BULLETS];
+    int bulletCount;
+    int shootTimer;
 
-        std::string dyingImagePath = ASSETS_PATH + "enemy_dying_sheet.png";
-        SDL_Surface* dyingSurface = IMG_Load(dyingImagePath.c_str());
-        dyingTexture = dyingSurface ? SDL_CreateTextureFromSurface(renderer, dyingSurface) : nullptr;
-        if (!dyingSurface) std::cerr << "❌ Không tải được " << dyingImagePath << ": " << IMG_GetError() << std::endl;
-        if (dyingSurface) SDL_FreeSurface(dyingSurface);
+    static void listAssets(std::vector<std::string>& paths) {
+        paths.push_back(ASSETS_PATH + "enemy_sheet.png");
+        paths.push_back(ASSETS_PATH + "enemy_attack_sheet.png");
+        paths.push_back(ASSETS_PATH + "enemy_hurt_sheet.png");
+        paths.push_back(ASSETS_PATH + "enemy_dying_sheet.png");
+        paths.push_back(ASSETS_PATH + "bullet.png");
+    }
 
-        currentFrame = 0;
-        frameCount = 4;
-        attackFrameCount = 8;
-        hurtFrameCount = 4;
-        dyingFrameCount = 6;
-        frameDelay = 8;
-        attackFrameDelay = 6;
-        hurtFrameDelay = 4;
-        dyingFrameDelay = 4;
-        frameTimer = 0;
-        isAttacking = false;
-        isHurt = false;
-        isDying = false;
-        toRemove = false;
-        hitCount = 0;
-        shootTimer = 0;
-        shootDelay = 1.9;
-        attackCooldown = 0;
-        attackCooldownMax = 60;
+    static size_t spawn(EntityColumns<Enemy>& columns, float start_x, float start_y, float min_x, float max_x, TextureManager& textureManager) {
+        size_t i = columns.add(start_x, start_y, min_x, max_x, 1.2f);
+        Enemy& enemy = columns.cold[i];
+        enemy.texture = textureManager.acquire(ASSETS_PATH + "enemy_sheet.png");
+        enemy.attackTexture = textureManager.acquire(ASSETS_PATH + "enemy_attack_sheet.png");
+        enemy.hurtTexture = textureManager.acquire(ASSETS_PATH + "enemy_hurt_sheet.png");
+        enemy.dyingTexture = textureManager.acquire(ASSETS_PATH + "enemy_dying_sheet.png");
+        enemy.bulletCount = 0;
+        enemy.shootTimer = 0;
+        return i;
     }
 
-    void update(float playerX, float playerY, TextureManager& textureManager, SDL_Renderer* renderer) {
-        if (isDying) {
-            frameTimer++;
-            if (frameTimer >= dyingFrameDelay) {
-                frameTimer = 0;
-                currentFrame++;
-                if (currentFrame >= dyingFrameCount) {
-                    toRemove = true;
+    // Cập nhật các hàng [begin, end); con trỏ cột lấy một lần ngoài vòng lặp. Hàng đang tuần tra chỉ
+    // được đánh dấu, bước di chuyển và hoạt ảnh của chúng chạy gộp trong patrolStep sau vòng lặp.
+    // Chỉ ghi vào hàng của mình nên các đoạn rời nhau chạy song song được; việc bắn để lại cho updateBullets.
+    static void update(EntityColumns<Enemy>& columns, size_t begin, size_t end, float playerX, float playerY) {
+        PROFILE_SCOPE("Enemy::update");
+        float* xs = columns.x.data();
+        int* currentFrames = columns.currentFrame.data();
+        int* frameTimers = columns.frameTimer.data();
+        const int* hitCounts = columns.hitCount.data();
+        int* attackCooldowns = columns.attackCooldown.data();
+        uint8_t* movingRights = columns.movingRight.data();
+        uint8_t* isAttackings = columns.isAttacking.data();
+        uint8_t* isHurts = columns.isHurt.data();
+        uint8_t* isDyings = columns.isDying.data();
+        uint8_t* toRemoves = columns.toRemove.data();
+        uint8_t* wantsShots = columns.wantsShot.data();
+        uint8_t* patrols = columns.patrol.data();
+        for (size_t i = begin; i < end; i++) {
+            patrols[i] = false;
+            float& x = xs[i];
+            uint8_t& movingRight = movingRights[i];
+            int& currentFrame = currentFrames[i];
+            int& frameTimer = frameTimers[i];
+            uint8_t& isAttacking = isAttackings[i];
+            uint8_t& isHurt = isHurts[i];
+            uint8_t& isDying = isDyings[i];
+            int& attackCooldown = attackCooldowns[i];
+
+            if (isDying) {
+                frameTimer++;
+                if (frameTimer >= dyingFrameDelay) {
+                    frameTimer = 0;
+                    currentFrame++;
+                    if (currentFrame >= dyingFrameCount) {
+                        toRemoves[i] = true;
+                    }
                 }
-            }
-        } else if (isHurt) {
-            frameTimer++;
-            if (frameTimer >= hurtFrameDelay) {
-                frameTimer = 0;
-                currentFrame++;
-                if (currentFrame >= hurtFrameCount) {
-                    isHurt = false;
-                    currentFrame = 0;
-                    if (hitCount >= 2) {
-                        isDying = true;
+            } else if (isHurt) {
+                frameTimer++;
+                if (frameTimer >= hurtFrameDelay) {
+                    frameTimer = 0;
+                    currentFrame++;
+                    if (currentFrame >= hurtFrameCount) {
+                        isHurt = false;
                         currentFrame = 0;
+                        if (hitCounts[i] >= hitsToDie) {
+                            isDying = true;
+                            currentFrame = 0;
+                        }
                     }
                 }
-            }
-        } else if (isAttacking) {
-            frameTimer++;
-            if (frameTimer >= attackFrameDelay) {
-                frameTimer = 0;
-                currentFrame++;
-                if (currentFrame >= attackFrameCount) {
-                    isAttacking = false;
-                    currentFrame = 0;
-                }
-            }
-        } else {
-            float distance = std::abs(playerX - x);
-            if (!movingRight && distance < 200) {
-                isAttacking = true;
-                currentFrame = 0;
-                shootTimer++;
-                if (shootTimer >= shootDelay && bullets.size() < 10) {
-                    shootTimer = 0;
-                    Bullet bullet;
-                    bullet.init(renderer, x, y, movingRight);
-                    bullets.push_back(bullet);
+            } else if (isAttacking) {
+                frameTimer++;
+                if (frameTimer >= attackFrameDelay) {
+                    frameTimer = 0;
+                    currentFrame++;
+                    if (currentFrame >= attackFrameCount) {
+                        isAttacking = false;
+                        currentFrame = 0;
+                    }
                 }
             } else {
-                if (movingRight) {
-                    x += speed;
-                    if (x >= max_x) {
-                        x = max_x;
-                        movingRight = false;
-                    }
+                float distance = std::abs(playerX - x);
+                if (!movingRight && distance < 200) {
+                    isAttacking = true;
+                    currentFrame = 0;
+                    wantsShots[i] = true;
                 } else {
-                    x -= speed;
-                    if (x <= min_x) {
-                        x = min_x;
-                        movingRight = true;
-                    }
+                    patrols[i] = true;
                 }
-                frameTimer++;
-                if (frameTimer >= frameDelay) {
-                    frameTimer = 0;
-                    currentFrame = (currentFrame + 1) % frameCount;
+            }
+
+            if (attackCooldown > 0) attackCooldown--;
+        }
+        patrolStep(patrolArrays(columns), begin, end, frameDelay, frameCount);
+    }
+
+    // Bắn và đẩy đạn theo đúng thứ tự hàng trên một luồng: BulletPool cấp slot theo thứ tự acquire/release
+    static void updateBullets(EntityColumns<Enemy>& columns, BulletPool& bulletPool) {
+        PROFILE_SCOPE("Enemy::updateBullets");
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns.wantsShot[i]) {
+                Enemy& enemy = columns.cold[i];
+                columns.wantsShot[i] = false;
+                enemy.shootTimer++;
+                if (enemy.shootTimer >= shootDelay && enemy.bulletCount < MAX_ENEMY_BULLETS) {
+                    enemy.shootTimer = 0;
+                    int slot = bulletPool.acquire(columns.x[i], columns.y[i], columns.movingRight[i]);
+                    if (slot >= 0) {
+                        bulletPool.get(slot).owner = columns.handleOf(i);
+                        enemy.bulletSlots[enemy.bulletCount++] = slot;
+                    }
                 }
             }
+
+            // Không còn viên đạn nào đang bay thì khỏi chạm vào phần cold
+            if (bulletPool.liveCount == 0) continue;
+            Enemy& enemy = columns.cold[i];
+            for (int k = 0; k < enemy.bulletCount; k++) {
+                bulletPool.get(enemy.bulletSlots[k]).update();
+            }
+            int kept = 0;
+            for (int k = 0; k < enemy.bulletCount; k++) {
+                if (bulletPool.get(enemy.bulletSlots[k]).toRemove) bulletPool.release(enemy.bulletSlots[k]);
+                else enemy.bulletSlots[kept++] = enemy.bulletSlots[k];
+            }
+            enemy.bulletCount = kept;
         }
+    }
 
-        if (attackCooldown > 0) attackCooldown--;
+    static SDL_Rect attackRect(const EntityColumns<Enemy>& columns, size_t i) {
+        SDL_Rect attackRect = { static_cast<int>(columns.x[i]), static_cast<int>(columns.y[i]), 100, 64 };
+        if (columns.movingRight[i]) {
+            attackRect.x += 20;
+        } else {
+            attackRect.x -= 100;
+        }
+        return attackRect;
+    }
 
-        for (auto& bullet : bullets) {
-            bullet.update();
+    // Còn bị đánh được thì có hurtbox; đang vung đòn và đã hồi chiêu thì có thêm hitbox
+    static void publishBoxes(const EntityColumns<Enemy>& columns, CombatWorld& combat, float cameraX) {
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns.isDying[i] || columns.isHurt[i]) continue;
+            SDL_Rect body = { combatX(columns.x[i], cameraX), static_cast<int>(columns.y[i]), 64, 64 };
+            combat.addHurtbox(body, FACTION_ENEMY, OWNER_ENEMY, i);
+            if (columns.isAttacking[i] && columns.attackCooldown[i] <= 0) {
+                combat.addHitbox(attackRect(columns, i), FACTION_ENEMY, attackDamage, OWNER_ENEMY, i);
+            }
         }
-        bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
-            [](const Bullet& b) { return b.toRemove; }), bullets.end());
     }
 
-    void render(SDL_Renderer* renderer, float cameraX) {
-        SDL_Rect dstRect = { static_cast<int>(x - cameraX), static_cast<int>(y), 64, 64 };
+    static void takeHit(EntityColumns<Enemy>& columns, size_t i) {
+        columns.isHurt[i] = true;
+        columns.currentFrame[i] = 0;
+        columns.hitCount[i]++;
+        if (columns.hitCount[i] >= hitsToDie) {
+            columns.isHurt[i] = false;
+            columns.isDying[i] = true;
+            columns.currentFrame[i] = 0;
+        }
+    }
+
+    static void render(const EntityColumns<Enemy>& columns, size_t i, SDL_Renderer* renderer, float cameraX) {
+        SDL_Rect dstRect = { static_cast<int>(columns.x[i] - cameraX), static_cast<int>(columns.y[i]), 64, 64 };
         if (dstRect.x + dstRect.w > 0 && dstRect.x < SCREEN_WIDTH) {
-            SDL_Texture* currentTexture;
+            const Enemy& enemy = columns.cold[i];
+            TextureHandle currentTexture;
             int frameWidth = 81;
             int frameHeight = 71;
-            if (isDying) {
-                currentTexture = dyingTexture;
-            } else if (isHurt) {
-                currentTexture = hurtTexture;
-            } else if (isAttacking) {
-                currentTexture = attackTexture;
+            if (columns.isDying[i]) {
+                currentTexture = enemy.dyingTexture;
+            } else if (columns.isHurt[i]) {
+                currentTexture = enemy.hurtTexture;
+            } else if (columns.isAttacking[i]) {
+                currentTexture = enemy.attackTexture;
             } else {
-                currentTexture = texture;
+                currentTexture = enemy.texture;
             }
-            SDL_Rect srcRect = { currentFrame * frameWidth, 0, frameWidth, frameHeight };
-            SDL_RendererFlip flip = movingRight ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-            if (currentTexture) {
-                SDL_RenderCopyEx(renderer, currentTexture, &srcRect, &dstRect, 0, NULL, flip);
+            SDL_Rect srcRect = { columns.currentFrame[i] * frameWidth, 0, frameWidth, frameHeight };
+            SDL_RendererFlip flip = columns.movingRight[i] ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
+            if (currentTexture.get()) {
+                renderCopy(renderer, currentTexture, &srcRect, &dstRect, flip);
             } else {
                 SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
                 SDL_RenderFillRect(renderer, &dstRect);
@@ -184,13 +213,14 @@ struct Enemy {
         }
     }
 
-    void cleanup() {
-        if (texture) SDL_DestroyTexture(texture);
-        if (attackTexture) SDL_DestroyTexture(attackTexture);
-        if (hurtTexture) SDL_DestroyTexture(hurtTexture);
-        if (dyingTexture) SDL_DestroyTexture(dyingTexture);
-        for (auto& bullet : bullets) {
-            bullet.cleanup();
+    void cleanup(TextureManager& textureManager, BulletPool& bulletPool) {
+        textureManager.release(texture);
+        textureManager.release(attackTexture);
+        textureManager.release(hurtTexture);
+        textureManager.release(dyingTexture);
+        for (int i = 0; i < bulletCount; i++) {
+            bulletPool.release(bulletSlots[i]);
         }
+        bulletCount = 0;
     }
 };
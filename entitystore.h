@@ -0,0 +1,160 @@
+// Kẻ địch được lưu theo cột (SoA), mỗi loại một bảng: các trường nóng nằm trong mảng liền nhau để
+// vòng update và cull chỉ kéo vào cache đúng những cột chúng đọc. Texture, đạn và trường riêng
+// của từng loại nằm ở cột cold. Hàng i của mọi cột là cùng một thực thể.
+//
+// Bảng là một slot map: xóa hàng thì chuyển hàng cuối vào chỗ trống (O(1)), nên chỉ số hàng không
+// bền qua removeMarked. Ai cần giữ tham chiếu qua nhiều tick thì giữ EntityHandle: slot trỏ tới hàng
+// hiện tại, generation tăng mỗi lần slot được thu hồi nên handle cũ tự thành không hợp lệ.
+struct EntityHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+template <typename Cold>
+struct EntityColumns {
+    std::vector<float> x, y;
+    std::vector<float> previousX, previousY;   // Vị trí ở tick trước, để nội suy khi vẽ
+    std::vector<float> speed;
+    std::vector<float> minX, maxX;             // Đoạn tuần tra
+    std::vector<int> currentFrame;
+    std::vector<int> frameTimer;
+    std::vector<int> hitCount;
+    std::vector<int> attackCooldown;
+    std::vector<uint8_t> movingRight;
+    std::vector<uint8_t> isAttacking;
+    std::vector<uint8_t> isHurt;
+    std::vector<uint8_t> isDying;
+    std::vector<uint8_t> isIdle;
+    std::vector<uint8_t> isMoving;
+    std::vector<uint8_t> toRemove;
+    std::vector<uint8_t> wantsShot;           // Enemy: xin bắn trong tick này, Enemy::updateBullets cấp đạn
+    std::vector<uint8_t> patrol;              // Vòng update đánh dấu hàng đang tuần tra cho patrolStep
+    std::vector<uint32_t> spatialId;          // Id trong SpatialHash, SPATIAL_NONE khi chưa chèn
+    std::vector<uint32_t> slot;               // Slot của handle trỏ tới hàng này
+    std::vector<Cold> cold;
+    std::vector<uint32_t> slotRow;            // Theo slot: hàng hiện tại, UINT32_MAX khi slot trống
+    std::vector<uint32_t> slotGeneration;
+    std::vector<uint32_t> freeSlots;
+
+    template <typename F>
+    void forEachColumn(F f) {
+        f(x); f(y);
+        f(previousX); f(previousY);
+        f(speed);
+        f(minX); f(maxX);
+        f(currentFrame);
+        f(frameTimer);
+        f(hitCount);
+        f(attackCooldown);
+        f(movingRight);
+        f(isAttacking);
+        f(isHurt);
+        f(isDying);
+        f(isIdle);
+        f(isMoving);
+        f(toRemove);
+        f(wantsShot);
+        f(patrol);
+        f(spatialId);
+        f(slot);
+        f(cold);
+    }
+
+    size_t size() const {
+        return x.size();
+    }
+
+    // Thêm một hàng đang tuần tra sang phải; phần cold do từng loại tự khởi tạo
+    size_t add(float startX, float startY, float minX, float maxX, float speed) {
+        forEachColumn([](auto& column) { column.emplace_back(); });
+        size_t i = size() - 1;
+        uint32_t s;
+        if (!freeSlots.empty()) {
+            s = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            s = static_cast<uint32_t>(slotRow.size());
+            slotRow.push_back(0);
+            slotGeneration.push_back(0);
+        }
+        slotRow[s] = static_cast<uint32_t>(i);
+        slot[i] = s;
+        x[i] = startX;
+        y[i] = startY;
+        previousX[i] = startX;
+        previousY[i] = startY;
+        this->speed[i] = speed;
+        this->minX[i] = minX;
+        this->maxX[i] = maxX;
+        movingRight[i] = true;
+        isIdle[i] = true;
+        return i;
+    }
+
+    EntityHandle handleOf(size_t i) const {
+        return { slot[i], slotGeneration[slot[i]] };
+    }
+
+    // Hàng hiện tại của handle, -1 nếu thực thể đã bị xóa
+    int rowOf(EntityHandle handle) const {
+        if (handle.slot >= slotRow.size() || slotGeneration[handle.slot] != handle.generation) return -1;
+        return static_cast<int>(slotRow[handle.slot]);
+    }
+
+    // Gọi f(hàng) theo thứ tự slot. Store mới hoặc vừa clear() cấp slot tăng dần nên với World vừa dựng
+    // đây là thứ tự spawn; slot do eraseRow thu hồi được cấp lại trước (LIFO) cho lần spawn sau đó.
+    // Thứ tự chỉ phụ thuộc chuỗi add/erase, không phụ thuộc việc swap-and-pop đã đảo hàng thế nào
+    template <typename F>
+    void forEachInSlotOrder(F f) const {
+        for (uint32_t row : slotRow) {
+            if (row != UINT32_MAX) f(static_cast<size_t>(row));
+        }
+    }
+
+    void storePrevious() {
+        previousX = x;
+        previousY = y;
+    }
+
+    // Swap-and-pop: hàng cuối chuyển vào hàng i, slot của hàng i được thu hồi
+    void eraseRow(size_t i) {
+        uint32_t freed = slot[i];
+        slotRow[freed] = UINT32_MAX;
+        slotGeneration[freed]++;
+        freeSlots.push_back(freed);
+        size_t last = size() - 1;
+        if (i != last) {
+            forEachColumn([i, last](auto& column) { column[i] = std::move(column[last]); });
+            slotRow[slot[i]] = static_cast<uint32_t>(i);
+        }
+        forEachColumn([](auto& column) { column.pop_back(); });
+    }
+
+    // Bỏ các hàng toRemove (release(i) dọn hàng đó trước). Mỗi hàng bỏ đi tốn một lần chuyển hàng
+    // cuối vào chỗ trống; hàng vừa chuyển vào được xét lại ngay. Trả về số hàng đã bỏ.
+    template <typename Release>
+    size_t removeMarked(Release release) {
+        size_t removed = 0;
+        size_t i = 0;
+        while (i < size()) {
+            if (!toRemove[i]) {
+                i++;
+                continue;
+            }
+            release(i);
+            eraseRow(i);
+            removed++;
+        }
+        return removed;
+    }
+
+    // Mọi handle đang có đều mất hiệu lực. freeSlots được xếp lại giảm dần để các lần add() sau
+    // nhận slot 0, 1, 2... như một store mới
+    void clear() {
+        for (uint32_t s : slot) slotGeneration[s]++;
+        std::fill(slotRow.begin(), slotRow.end(), UINT32_MAX);
+        freeSlots.clear();
+        for (size_t s = slotRow.size(); s > 0; s--) freeSlots.push_back(static_cast<uint32_t>(s - 1));
+        forEachColumn([](auto& column) { column.clear(); });
+    }
+};
@@ -0,0 +1,247 @@
+// Chế độ dev (--dev): theo dõi các file level .dat, khi được lưu thì so với level đang nạp
+// và chỉ vá phần thay đổi. Người chơi, camera, texture, nhạc và font giữ nguyên.
+
+// Khác biệt giữa hai phiên bản của cùng một level
+struct LevelDiff {
+    int changedCells = 0;
+    int firstColumn = -1;   // Khoảng cột có ô thay đổi, -1 nếu lưới giống hệt
+    int lastColumn = -1;
+    bool resized = false;
+    std::vector<LevelSpawn> removedSpawns;
+    std::vector<LevelSpawn> addedSpawns;
+    std::vector<LevelPoint> removedDoors;
+    std::vector<LevelPoint> addedDoors;
+    std::vector<LevelPoint> removedItems;
+    std::vector<LevelPoint> addedItems;
+};
+
+bool spawnLess(const LevelSpawn& a, const LevelSpawn& b) {
+    if (a.type != b.type) return a.type < b.type;
+    if (a.minX != b.minX) return a.minX < b.minX;
+    if (a.maxX != b.maxX) return a.maxX < b.maxX;
+    return a.y < b.y;
+}
+
+bool pointLess(const LevelPoint& a, const LevelPoint& b) {
+    return a.x != b.x ? a.x < b.x : a.y < b.y;
+}
+
+// removed = before - after, added = after - before (theo multiset, không phụ thuộc thứ tự)
+template <typename T, typename Less>
+void diffLists(std::vector<T> before, std::vector<T> after, Less less, std::vector<T>& removed, std::vector<T>& added) {
+    std::sort(before.begin(), before.end(), less);
+    std::sort(after.begin(), after.end(), less);
+    std::set_difference(before.begin(), before.end(), after.begin(), after.end(), std::back_inserter(removed), less);
+    std::set_difference(after.begin(), after.end(), before.begin(), before.end(), std::back_inserter(added), less);
+}
+
+LevelDiff diffLevels(const LevelData& before, const LevelData& after) {
+    LevelDiff diff;
+    if (before.width != after.width || before.height != after.height) {
+        diff.resized = true;
+        diff.changedCells = after.width * after.height;
+        diff.firstColumn = 0;
+        diff.lastColumn = std::max(before.width, after.width) - 1;
+    } else {
+        for (int col = 0; col < after.width; col++) {
+            for (int row = 0; row < after.height; row++) {
+                if (before.tile(row, col) == after.tile(row, col)) continue;
+                diff.changedCells++;
+                if (diff.firstColumn < 0) diff.firstColumn = col;
+                diff.lastColumn = col;
+            }
+        }
+    }
+    // Spawn đã chứa mặt đất nên sửa nền tảng bên dưới một nhóm kẻ địch cũng làm nhóm đó đổi
+    diffLists(before.spawns, after.spawns, spawnLess, diff.removedSpawns, diff.addedSpawns);
+    diffLists(before.doors, after.doors, pointLess, diff.removedDoors, diff.addedDoors);
+    diffLists(before.items, after.items, pointLess, diff.removedItems, diff.addedItems);
+    return diff;
+}
+
+// Thực thể còn sống được sinh ra từ spawn; nếu nhiều nhóm trùng cột thì lấy con gần hàng của spawn nhất
+template <typename Cold>
+int findSpawned(const EntityColumns<Cold>& columns, const LevelSpawn& spawn, float offset) {
+    int found = -1;
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (columns.toRemove[i] || columns.minX[i] != spawn.minX + offset || columns.maxX[i] != spawn.maxX + offset) continue;
+        if (found < 0 || std::abs(columns.y[i] - spawn.y) < std::abs(columns.y[found] - spawn.y)) found = static_cast<int>(i);
+    }
+    return found;
+}
+
+template <typename T>
+int findAt(const std::vector<T>& list, const LevelPoint& point) {
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i].rect.x == point.x && list[i].rect.y == point.y) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// world.level đã trỏ tới dữ liệu mới; vật phẩm và kẻ địch không bị sửa giữ nguyên trạng thái.
+// Trả về số chunk đã dựng lại.
+int patchWorld(World& world, const LevelDiff& diff, SDL_Renderer* renderer, TextureManager& textureManager, BulletPool& bulletPool) {
+    for (const auto& point : diff.removedDoors) {
+        int i = findAt(world.doors, point);
+        if (i < 0) continue;
+        world.doors[i].cleanup();
+        world.doors.erase(world.doors.begin() + i);
+    }
+    for (const auto& point : diff.addedDoors) {
+        Door door;
+        door.init(renderer, point.x, point.y, textureManager);
+        world.doors.push_back(door);
+    }
+    for (const auto& point : diff.removedItems) {
+        int i = findAt(world.items, point);
+        if (i < 0) continue;
+        world.items[i].cleanup(textureManager);
+        world.items.erase(world.items.begin() + i);
+    }
+    for (const auto& point : diff.addedItems) {
+        Item item;
+        item.init(renderer, point.x, point.y, textureManager);
+        world.items.push_back(item);
+    }
+
+    EntityStore& entities = world.entities;
+    for (const auto& spawn : diff.removedSpawns) {
+        int i;
+        if (spawn.type == 2 && (i = findSpawned(entities.enemies, spawn, 0)) >= 0) {
+            entities.enemies.cold[i].cleanup(textureManager, bulletPool);
+            entities.enemies.eraseRow(i);
+        } else if (spawn.type == 4 && (i = findSpawned(entities.newEnemies, spawn, 0)) >= 0) {
+            entities.newEnemies.cold[i].cleanup(textureManager);
+            entities.newEnemies.eraseRow(i);
+        } else if (spawn.type == 5 && (i = findSpawned(entities.newEnemies5, spawn, 0)) >= 0) {
+            entities.newEnemies5.cold[i].cleanup(textureManager);
+            entities.newEnemies5.eraseRow(i);
+        } else if (spawn.type == 8 && (i = findSpawned(entities.bosses, spawn, BOSS_SPAWN_OFFSET)) >= 0) {
+            entities.bosses.cold[i].cleanup(textureManager);
+            entities.bosses.eraseRow(i);
+        }
+    }
+    for (const auto& spawn : diff.addedSpawns) entities.spawn(renderer, spawn, textureManager);
+    world.built = world.totalToBuild();
+    world.rebuildSpatial(bulletPool);
+
+    return diff.firstColumn >= 0 ? world.streamer.reloadColumns(diff.firstColumn, diff.lastColumn) : 0;
+}
+
+// Báo file level nào vừa được ghi xong. Linux dùng inotify trên thư mục (trình soạn thảo hay ghi
+// file tạm rồi đổi tên), nơi khác thì so thời gian sửa đổi vài lần mỗi giây.
+struct LevelWatcher {
+    std::string directory;
+    std::vector<std::string> names;
+#ifdef __linux__
+    int fd = -1;
+#else
+    std::vector<time_t> modified;
+    int pollTimer = 0;
+#endif
+
+    bool init(const std::string& directory, const std::vector<std::string>& names) {
+        this->directory = directory;
+        this->names = names;
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0 || inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            std::cerr << "❌ Không theo dõi được thư mục " << directory << ": " << strerror(errno) << std::endl;
+            cleanup();
+            return false;
+        }
+#else
+        modified.assign(names.size(), 0);
+        for (size_t i = 0; i < names.size(); i++) {
+            struct stat info;
+            if (stat((directory + names[i]).c_str(), &info) == 0) modified[i] = info.st_mtime;
+        }
+#endif
+        return true;
+    }
+
+    void poll(std::vector<std::string>& changed) {
+        changed.clear();
+#ifdef __linux__
+        if (fd < 0) return;
+        alignas(struct inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char* cursor = buffer; cursor < buffer + length; ) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(cursor);
+                cursor += sizeof(struct inotify_event) + event->len;
+                if (event->len == 0) continue;
+                std::string name = event->name;
+                if (std::find(names.begin(), names.end(), name) != names.end() &&
+                    std::find(changed.begin(), changed.end(), name) == changed.end()) {
+                    changed.push_back(name);
+                }
+            }
+        }
+#else
+        if (names.empty() || ++pollTimer < 30) return;
+        pollTimer = 0;
+        for (size_t i = 0; i < names.size(); i++) {
+            struct stat info;
+            if (stat((directory + names[i]).c_str(), &info) != 0 || info.st_mtime == modified[i]) continue;
+            modified[i] = info.st_mtime;
+            changed.push_back(names[i]);
+        }
+#endif
+    }
+
+    void cleanup() {
+#ifdef __linux__
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+    }
+};
+
+// Đọc lại file .dat từ đĩa (bỏ qua bundle và .lvl) rồi vá level cùng World đang dùng nó
+bool hotReloadLevel(const std::string& name, LevelData& level, World& world, LevelPrefetcher& prefetcher, Camera& camera,
+                    SDL_Renderer* renderer, TextureManager& textureManager, BulletPool& bulletPool) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    std::string path = ASSETS_PATH + name + ".dat";
+    std::ifstream disk(path);
+    if (!disk.is_open()) {
+        std::cerr << "❌ Không mở được tệp: " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << disk.rdbuf();
+    LevelData fresh;
+    if (!parseLevelText(buffer.str(), fresh, path)) {
+        std::cerr << "❌ Giữ nguyên " << name << " cũ" << std::endl;
+        return false;
+    }
+
+    LevelDiff diff = diffLevels(level, fresh);
+    // World và prefetcher giữ con trỏ tới level nên thay nội dung tại chỗ
+    level.close();
+    level.width = fresh.width;
+    level.height = fresh.height;
+    level.spawns = std::move(fresh.spawns);
+    level.doors = std::move(fresh.doors);
+    level.items = std::move(fresh.items);
+    level.ownedTiles = std::move(fresh.ownedTiles);
+    level.packedTiles = level.ownedTiles.data();
+
+    if (prefetcher.pending == &level) prefetcher.reset(textureManager, bulletPool);
+    int chunksRebuilt = 0;
+    if (world.level == &level) {
+        chunksRebuilt = patchWorld(world, diff, renderer, textureManager, bulletPool);
+        if (diff.resized) {
+            levelWidthPixels = level.width * TILE_WIDTH;
+            camera.mapWidthPixels = levelWidthPixels;
+            world.streamer.update(camera.x);
+        }
+    }
+
+    double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    std::cout << "Hot reload: " << name << " " << diff.changedCells << " cells changed, "
+              << chunksRebuilt << " chunks rebuilt, spawns +" << diff.addedSpawns.size()
+              << "/-" << diff.removedSpawns.size() << ", doors +" << diff.addedDoors.size() << "/-" << diff.removedDoors.size()
+              << ", items +" << diff.addedItems.size() << "/-" << diff.removedItems.size() << " in " << ms << " ms" << std::endl;
+    return true;
+}
@@ -1,17 +1,20 @@
 struct Item {
     SDL_Rect rect;
-    SDL_Texture* texture;
+    TextureHandle texture;
     bool isCollected;
+    uint32_t spatialId;
 
-    void init(SDL_Renderer* renderer, int x, int y) {
+    static void listAssets(std::vector<std::string>& paths) {
+        paths.push_back(ASSETS_PATH + "item.png");
+    }
+
+    void init(SDL_Renderer* renderer, int x, int y, TextureManager& textureManager) {
         int offsetX = 6;
         int offsetY = 15;
         rect = { x + offsetX, y + offsetY, 40, 40 };
         isCollected = false;
-        texture = IMG_LoadTexture(renderer, (ASSETS_PATH + "item.png").c_str());
-        if (!texture) {
-            std::cerr << "❌ Không tải được item.png: " << IMG_GetError() << std::endl;
-        }
+        spatialId = SPATIAL_NONE;
+        texture = textureManager.acquire(ASSETS_PATH + "item.png");
     }
 
     void render(SDL_Renderer* renderer, float cameraX) {
@@ -19,8 +22,8 @@ struct Item {
         SDL_Rect renderRect = rect;
         renderRect.x -= static_cast<int>(cameraX);
         if (renderRect.x + renderRect.w > 0 && renderRect.x < SCREEN_WIDTH) {
-            if (texture) {
-                SDL_RenderCopy(renderer, texture, NULL, &renderRect);
+            if (texture.get()) {
+                renderCopy(renderer, texture, NULL, &renderRect);
             } else {
                 SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
                 SDL_RenderFillRect(renderer, &renderRect);
@@ -28,10 +31,7 @@ struct Item {
         }
     }
 
-    void cleanup() {
-        if (texture) {
-            SDL_DestroyTexture(texture);
-            texture = nullptr;
-        }
+    void cleanup(TextureManager& textureManager) {
+        textureManager.release(texture);
     }
 };
@@ -0,0 +1,180 @@
+const size_t JOB_MIN_GRAIN = 1024;   // Ít hàng hơn thế này thì chạy luôn trên luồng gọi, không chia việc
+
+// Một đoạn [begin, end) của một parallelFor
+struct Job {
+    void (*run)(void* body, size_t begin, size_t end);
+    void* body;
+    size_t begin, end;
+    SDL_atomic_t* pending;
+};
+
+// Chủ deque lấy việc ở cuối (việc vừa đẩy, còn nóng trong cache), luồng khác lấy trộm từ đầu
+struct JobQueue {
+    SDL_SpinLock lock = 0;
+    std::deque<Job> jobs;
+};
+
+struct JobWorkerStats {
+    long long jobs = 0;
+    long long steals = 0;
+    Uint64 busy = 0;   // Tổng SDL_GetPerformanceCounter trong lúc chạy việc
+};
+
+// Bộ lập lịch work-stealing: mỗi worker một deque, luồng chính là worker 0 và cũng làm việc trong lúc
+// chờ parallelFor xong. Worker hết việc thì đi trộm từ deque của luồng khác, hết hẳn thì ngủ trên cond.
+struct JobSystem {
+    std::vector<SDL_Thread*> threads;
+    std::vector<JobQueue> queues;
+    std::vector<JobWorkerStats> stats;
+    SDL_mutex* mutex = nullptr;
+    SDL_cond* wake = nullptr;
+    SDL_atomic_t queued;    // Số việc còn nằm trong các deque
+    SDL_atomic_t started;
+    bool stopping = false;
+    long long parallelFors = 0;
+    Uint64 startCounter = 0;
+
+    // workerCount = 0: mọi parallelFor chạy tuần tự trên luồng gọi
+    void init(int workerCount) {
+        queues = std::vector<JobQueue>(workerCount + 1);
+        stats.assign(workerCount + 1, {});
+        SDL_AtomicSet(&queued, 0);
+        SDL_AtomicSet(&started, 0);
+        stopping = false;
+        startCounter = SDL_GetPerformanceCounter();
+        if (workerCount == 0) return;
+        mutex = SDL_CreateMutex();
+        wake = SDL_CreateCond();
+        for (int i = 0; i < workerCount; i++) {
+            SDL_Thread* thread = SDL_CreateThread(workerMain, "job-worker", this);
+            if (thread) threads.push_back(thread);
+            else std::cerr << "❌ Không tạo được luồng job: " << SDL_GetError() << std::endl;
+        }
+    }
+
+    size_t workerCount() const {
+        return threads.size();
+    }
+
+    bool pop(int self, Job& job) {
+        JobQueue& queue = queues[self];
+        SDL_AtomicLock(&queue.lock);
+        bool found = !queue.jobs.empty();
+        if (found) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        SDL_AtomicUnlock(&queue.lock);
+        if (found) SDL_AtomicAdd(&queued, -1);
+        return found;
+    }
+
+    // Đi một vòng qua các deque khác, bắt đầu từ ngay sau mình để các worker không cùng dồn vào một chỗ
+    bool steal(int self, Job& job) {
+        int count = static_cast<int>(queues.size());
+        for (int offset = 1; offset < count; offset++) {
+            JobQueue& queue = queues[(self + offset) % count];
+            if (!SDL_AtomicTryLock(&queue.lock)) continue;
+            bool found = !queue.jobs.empty();
+            if (found) {
+                job = queue.jobs.front();
+                queue.jobs.pop_front();
+            }
+            SDL_AtomicUnlock(&queue.lock);
+            if (found) {
+                SDL_AtomicAdd(&queued, -1);
+                stats[self].steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void execute(int self, const Job& job) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        job.run(job.body, job.begin, job.end);
+        stats[self].busy += SDL_GetPerformanceCounter() - start;
+        stats[self].jobs++;
+        SDL_AtomicAdd(job.pending, -1);
+    }
+
+    static int workerMain(void* data) {
+        JobSystem* system = static_cast<JobSystem*>(data);
+        int self = SDL_AtomicAdd(&system->started, 1) + 1;
+        profiler.thread();
+        Job job;
+        while (true) {
+            if (system->pop(self, job) || system->steal(self, job)) {
+                system->execute(self, job);
+                continue;
+            }
+            SDL_LockMutex(system->mutex);
+            while (SDL_AtomicGet(&system->queued) == 0 && !system->stopping) {
+                SDL_CondWait(system->wake, system->mutex);
+            }
+            bool stop = system->stopping;
+            SDL_UnlockMutex(system->mutex);
+            if (stop) return 0;
+        }
+    }
+
+    template <typename Body>
+    static void runBody(void* body, size_t begin, size_t end) {
+        (*static_cast<Body*>(body))(begin, end);
+    }
+
+    // Gọi body(begin, end) trên các đoạn rời nhau phủ [0, count) rồi chờ hết. Các đoạn được chia đều
+    // vào deque của mọi luồng; body chỉ được ghi vào hàng của đoạn mình.
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body body) {
+        if (count == 0) return;
+        if (threads.empty() || count <= grain) {
+            body(static_cast<size_t>(0), count);
+            return;
+        }
+        parallelFors++;
+        size_t chunk = std::max(grain, (count + queues.size() * 4 - 1) / (queues.size() * 4));
+        size_t jobCount = (count + chunk - 1) / chunk;
+        SDL_atomic_t pending;
+        SDL_AtomicSet(&pending, static_cast<int>(jobCount));
+        SDL_AtomicAdd(&queued, static_cast<int>(jobCount));
+        for (size_t j = 0; j < jobCount; j++) {
+            JobQueue& queue = queues[j % queues.size()];
+            Job job = { runBody<Body>, &body, j * chunk, std::min(count, (j + 1) * chunk), &pending };
+            SDL_AtomicLock(&queue.lock);
+            queue.jobs.push_back(job);
+            SDL_AtomicUnlock(&queue.lock);
+        }
+        SDL_LockMutex(mutex);
+        SDL_CondBroadcast(wake);
+        SDL_UnlockMutex(mutex);
+
+        Job job;
+        while (SDL_AtomicGet(&pending) > 0) {
+            if (pop(0, job) || steal(0, job)) execute(0, job);
+        }
+    }
+
+    void printStats() const {
+        if (threads.empty()) return;
+        double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - startCounter);
+        std::cout << "Jobs: " << threads.size() << " workers + main, " << parallelFors << " parallel-fors" << std::endl;
+        for (size_t i = 0; i < stats.size(); i++) {
+            std::cout << "  " << (i == 0 ? "main" : "worker " + std::to_string(i)) << ": "
+                      << (elapsed > 0 ? 100.0 * stats[i].busy / elapsed : 0.0) << "% busy, "
+                      << stats[i].jobs << " jobs, " << stats[i].steals << " steals" << std::endl;
+        }
+    }
+
+    void cleanup() {
+        if (threads.empty()) return;
+        SDL_LockMutex(mutex);
+        stopping = true;
+        SDL_CondBroadcast(wake);
+        SDL_UnlockMutex(mutex);
+        for (SDL_Thread* thread : threads) SDL_WaitThread(thread, NULL);
+        threads.clear();
+        SDL_DestroyCond(wake);
+        SDL_DestroyMutex(mutex);
+    }
+};
@@ -0,0 +1,278 @@
+// Dữ liệu level dùng chung cho game và tools/levelc.
+// File .lvl: LevelFileHeader | LevelSpawn[spawnCount] | LevelPoint[doorCount] | LevelPoint[itemCount] | ô (4 bit mỗi ô)
+// Spawn đã được tính sẵn mặt đất nên game không phải dò nền tảng bên dưới mỗi nhóm kẻ địch nữa.
+// Ô được lưu theo cột (col * height + row) để một chunk cột là một vùng byte liền nhau.
+const uint32_t LEVEL_VERSION = 2;
+const int LEVEL_TILE_BITS = 4;
+const int LEVEL_TILE_MASK = (1 << LEVEL_TILE_BITS) - 1;
+const int CHUNK_COLUMNS = SCREEN_WIDTH / TILE_WIDTH;   // Một chunk rộng đúng một màn hình
+const float LEVEL_SPAWN_MAX_RAISE = 64 + 35;           // resolveLevel đặt kẻ địch cao hơn mặt đất tối đa chừng này
+
+struct LevelFileHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    uint32_t spawnCount;
+    uint32_t doorCount;
+    uint32_t itemCount;
+    uint32_t reserved;
+};
+
+struct LevelSpawn {
+    int32_t type;
+    float minX;
+    float maxX;
+    float y;
+};
+
+struct LevelPoint {
+    int32_t x;
+    int32_t y;
+};
+
+// Không sao chép LevelData: packedTiles trỏ vào ownedTiles, file đã mmap hoặc bundle
+struct LevelData {
+    int width = 0;
+    int height = 0;
+    std::vector<LevelSpawn> spawns;
+    std::vector<LevelPoint> doors;
+    std::vector<LevelPoint> items;
+    const uint8_t* packedTiles = nullptr;
+    std::vector<uint8_t> ownedTiles;
+    MappedFile file;
+
+    uint8_t tile(int row, int col) const {
+        size_t i = static_cast<size_t>(col) * height + row;
+        return (packedTiles[i / 2] >> ((i % 2) * LEVEL_TILE_BITS)) & LEVEL_TILE_MASK;
+    }
+
+    void close() {
+        file.unmap();
+        packedTiles = nullptr;
+        ownedTiles.clear();
+        spawns.clear();
+        doors.clear();
+        items.clear();
+    }
+};
+
+bool isPlatformTile(int value) {
+    return value == 1 || value == 3;
+}
+
+bool isEnemyTile(int value) {
+    return value == 2 || value == 4 || value == 5 || value == 8;
+}
+
+// Tìm sẵn vị trí cửa, vật phẩm và mặt đất cho từng nhóm kẻ địch liền nhau trên một hàng
+void resolveLevel(LevelData& level) {
+    level.spawns.clear();
+    level.doors.clear();
+    level.items.clear();
+
+    for (int i = 0; i < level.height; i++) {
+        for (int j = 0; j < level.width; j++) {
+            if (level.tile(i, j) == 6) level.doors.push_back({ j * TILE_WIDTH, i * TILE_HEIGHT });
+            else if (level.tile(i, j) == 7) level.items.push_back({ j * TILE_WIDTH, i * TILE_HEIGHT });
+        }
+    }
+
+    for (int i = 0; i < level.height; i++) {
+        int j = 0;
+        while (j < level.width) {
+            if (!isEnemyTile(level.tile(i, j))) {
+                j++;
+                continue;
+            }
+            int enemyType = level.tile(i, j);
+            int start_col = j;
+            while (j < level.width && level.tile(i, j) == enemyType) j++;
+            int end_col = j - 1;
+
+            int foundPlatformRow = -1;
+            for (int row = i + 1; row < level.height && foundPlatformRow == -1; row++) {
+                for (int col = start_col; col <= end_col; col++) {
+                    if (isPlatformTile(level.tile(row, col))) {
+                        foundPlatformRow = row;
+                        break;
+                    }
+                }
+            }
+            if (foundPlatformRow == -1) {
+                std::cerr << "Không tìm thấy nền tảng bên dưới kẻ địch ở hàng " << i << std::endl;
+                continue;
+            }
+
+            float y = foundPlatformRow * TILE_HEIGHT - 64;
+            if (enemyType == 4 || enemyType == 8) y -= 35;
+            level.spawns.push_back({ enemyType, static_cast<float>(start_col * TILE_WIDTH),
+                                     static_cast<float>((end_col + 1) * TILE_WIDTH), y });
+        }
+    }
+}
+
+// Số ô nền tảng và số dải sau khi gộp các ô cùng loại liền nhau trong từng hàng của mỗi chunk
+void countPlatformSpans(const LevelData& level, int& tiles, int& spans) {
+    tiles = 0;
+    spans = 0;
+    for (int row = 0; row < level.height; row++) {
+        int previous = 0;
+        for (int col = 0; col < level.width; col++) {
+            int value = level.tile(row, col);
+            if (col % CHUNK_COLUMNS == 0) previous = 0;
+            if (isPlatformTile(value)) {
+                tiles++;
+                if (value != previous) spans++;
+            }
+            previous = value;
+        }
+    }
+}
+
+// Tách phần nguyên 8 ô để không tràn size_t 32 bit khi width * height gần INT32_MAX
+size_t packedTileBytes(int width, int height) {
+    size_t count = static_cast<size_t>(width) * height;
+    return count / 8 * LEVEL_TILE_BITS + (count % 8 * LEVEL_TILE_BITS + 7) / 8;
+}
+
+// Định dạng văn bản cũ: mỗi dòng một hàng ô, các số cách nhau bằng khoảng trắng
+bool parseLevelText(const std::string& text, LevelData& level, const std::string& name) {
+    std::istringstream file(text);
+    std::string line;
+    std::vector<uint8_t> rows;
+    level.close();
+    level.width = 0;
+    level.height = 0;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        int col = 0;
+        int value;
+        while (iss >> value) {
+            if (value < 0 || value > LEVEL_TILE_MASK) {
+                std::cerr << "❌ Giá trị ô " << value << " không hợp lệ ở hàng " << level.height + 1 << " trong " << name << std::endl;
+                return false;
+            }
+            rows.push_back(static_cast<uint8_t>(value));
+            col++;
+        }
+        if (col == 0) continue;
+        if (level.height == 0) level.width = col;
+        if (col != level.width) {
+            std::cerr << "❌ Số cột không hợp lệ ở hàng " << level.height + 1 << " trong " << name << std::endl;
+            return false;
+        }
+        level.height++;
+    }
+    if (level.height == 0) {
+        std::cerr << "❌ Level rỗng: " << name << std::endl;
+        return false;
+    }
+    level.ownedTiles.assign(packedTileBytes(level.width, level.height), 0);
+    for (int col = 0; col < level.width; col++) {
+        for (int row = 0; row < level.height; row++) {
+            size_t i = static_cast<size_t>(col) * level.height + row;
+            level.ownedTiles[i / 2] |= static_cast<uint8_t>(rows[row * level.width + col] << ((i % 2) * LEVEL_TILE_BITS));
+        }
+    }
+    level.packedTiles = level.ownedTiles.data();
+    resolveLevel(level);
+    return true;
+}
+
+std::vector<char> writeLevelBinary(const LevelData& level) {
+    LevelFileHeader header = {};
+    std::memcpy(header.magic, "HLVL", 4);
+    header.version = LEVEL_VERSION;
+    header.width = level.width;
+    header.height = level.height;
+    header.spawnCount = static_cast<uint32_t>(level.spawns.size());
+    header.doorCount = static_cast<uint32_t>(level.doors.size());
+    header.itemCount = static_cast<uint32_t>(level.items.size());
+
+    std::vector<char> out(sizeof(header));
+    std::memcpy(out.data(), &header, sizeof(header));
+    auto append = [&out](const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    };
+    append(level.spawns.data(), level.spawns.size() * sizeof(LevelSpawn));
+    append(level.doors.data(), level.doors.size() * sizeof(LevelPoint));
+    append(level.items.data(), level.items.size() * sizeof(LevelPoint));
+
+    append(level.packedTiles, packedTileBytes(level.width, level.height));
+    return out;
+}
+
+// Đọc thẳng từ vùng nhớ (bundle hoặc file đã mmap), không phân tích cú pháp.
+// Ô không được sao chép: packedTiles trỏ vào data nên data phải sống lâu hơn level.
+bool readLevelBinary(const uint8_t* data, size_t size, LevelData& level, const std::string& name) {
+    LevelFileHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "❌ " << name << " không phải level nhị phân" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, "HLVL", 4) != 0 || header.version != LEVEL_VERSION) {
+        std::cerr << "❌ " << name << " sai định dạng hoặc phiên bản" << std::endl;
+        return false;
+    }
+    // Mọi chỉ số ô và toạ độ pixel trong game là int
+    if (header.width <= 0 || header.height <= 0 || header.width > INT32_MAX / header.height ||
+        header.width > INT32_MAX / TILE_WIDTH || header.height > INT32_MAX / TILE_HEIGHT) {
+        std::cerr << "❌ " << name << " có kích thước " << header.width << "x" << header.height << " không hợp lệ" << std::endl;
+        return false;
+    }
+    // Mỗi phần được trừ dần khỏi số byte còn lại thay vì cộng dồn để không bị tràn số
+    size_t remaining = size - sizeof(header);
+    auto take = [&remaining](size_t count, size_t elementSize, size_t& bytes) {
+        if (count > remaining / elementSize) return false;
+        bytes = count * elementSize;
+        remaining -= bytes;
+        return true;
+    };
+    size_t spawnBytes, doorBytes, itemBytes, tileBytes;
+    if (!take(header.spawnCount, sizeof(LevelSpawn), spawnBytes) || !take(header.doorCount, sizeof(LevelPoint), doorBytes) ||
+        !take(header.itemCount, sizeof(LevelPoint), itemBytes) || !take(packedTileBytes(header.width, header.height), 1, tileBytes)) {
+        std::cerr << "❌ " << name << " bị cắt cụt" << std::endl;
+        return false;
+    }
+
+    const uint8_t* cursor = data + sizeof(header);
+    level.width = header.width;
+    level.height = header.height;
+    level.spawns.resize(header.spawnCount);
+    std::memcpy(level.spawns.data(), cursor, spawnBytes);
+    cursor += spawnBytes;
+    level.doors.resize(header.doorCount);
+    std::memcpy(level.doors.data(), cursor, doorBytes);
+    cursor += doorBytes;
+    level.items.resize(header.itemCount);
+    std::memcpy(level.items.data(), cursor, itemBytes);
+    cursor += itemBytes;
+
+    level.packedTiles = cursor;
+
+    // Bản ghi được dùng thẳng làm chỉ số và toạ độ nên phải nằm trong level
+    float levelWidth = static_cast<float>(header.width * TILE_WIDTH);
+    float levelHeight = static_cast<float>(header.height * TILE_HEIGHT);
+    for (const LevelSpawn& spawn : level.spawns) {
+        if (!isEnemyTile(spawn.type) || !std::isfinite(spawn.minX) || !std::isfinite(spawn.maxX) || !std::isfinite(spawn.y) ||
+            spawn.minX < 0 || spawn.minX > spawn.maxX || spawn.maxX > levelWidth ||
+            spawn.y < -LEVEL_SPAWN_MAX_RAISE || spawn.y > levelHeight) {
+            std::cerr << "❌ " << name << " có kẻ địch loại " << spawn.type << " không hợp lệ" << std::endl;
+            level.close();
+            return false;
+        }
+    }
+    for (const std::vector<LevelPoint>* points : { &level.doors, &level.items }) {
+        for (const LevelPoint& point : *points) {
+            if (point.x < 0 || point.y < 0 || point.x >= header.width * TILE_WIDTH || point.y >= header.height * TILE_HEIGHT) {
+                std::cerr << "❌ " << name << " có cửa hoặc vật phẩm nằm ngoài level (" << point.x << ", " << point.y << ")" << std::endl;
+                level.close();
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -7,194 +7,160 @@
 #include <vector>
 #include <algorithm>
 #include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
 #include <sstream>
 #include <cmath>
+#include <cstring>
+#include <cstdint>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include <cerrno>
+#include <iterator>
 #include "const.h"
+#include "mappedfile.h"
+#include "bundle.h"
+#include "level.h"
+#include "atlas.h"
 #include "open.h"
+#include "assetloader.h"
+#include "profiler.h"
+#include "jobs.h"
 #include "camera.h"
 #include "platform.h"
 #include "door.h"
+#include "chunks.h"
+#include "collision.h"
+#include "entitystore.h"
 #include "bullet.h"
+#include "spatialhash.h"
 #include "item.h"
+#include "patrol.h"
+#include "combat.h"
+#include "timestep.h"
 #include "newenemy5.h"
 #include "enemy.h"
 #include "newenemy4.h"
 #include "player.h"
 #include "boss.h"
+#include "world.h"
+#include "replay.h"
+#include "hotreload.h"
 #include "map.h"
 
-bool loadLevelMap(const std::string& filePath, int levelMap[MAP_HEIGHT][MAP_WIDTH]) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "❌ Không mở được tệp: " << filePath << std::endl;
-        return false;
+// Ưu tiên level đã biên dịch (.lvl, mmap hoặc lấy thẳng từ bundle); nếu không có, hỏng
+// hoặc cũ hơn file .dat thì quay về định dạng văn bản
+bool loadLevel(const std::string& name, LevelData& level) {
+    std::string binaryPath = ASSETS_PATH + name + ".lvl";
+    std::string textPath = ASSETS_PATH + name + ".dat";
+    bool loaded = false;
+
+    level.close();
+    const BundleEntry* packed = assetBundle.findPath(binaryPath);
+    struct stat binaryInfo, textInfo;
+    if (packed && packed->kind == BUNDLE_KIND_RAW) {
+        loaded = readLevelBinary(assetBundle.data(*packed), packed->size, level, binaryPath);
+    } else if (stat(binaryPath.c_str(), &binaryInfo) == 0) {
+        if (stat(textPath.c_str(), &textInfo) == 0 && textInfo.st_mtime > binaryInfo.st_mtime) {
+            std::cerr << "❌ " << binaryPath << " cũ hơn " << textPath << ", hãy chạy lại levelc" << std::endl;
+        } else if (level.file.map(binaryPath)) {
+            loaded = readLevelBinary(level.file.base, level.file.size, level, binaryPath);
+        }
     }
 
-    std::string line;
-    int row = 0;
-    while (std::getline(file, line) && row < MAP_HEIGHT) {
-        std::istringstream iss(line);
-        int col = 0;
-        int value;
-        while (iss >> value && col < MAP_WIDTH) {
-            levelMap[row][col] = value;
-            col++;
-        }
-        if (col != MAP_WIDTH) {
-            std::cerr << "❌ Số cột không hợp lệ ở hàng " << row + 1 << std::endl;
-            file.close();
-            return false;
+    if (!loaded) {
+        std::string text;
+        packed = assetBundle.findPath(textPath);
+        if (packed && packed->kind == BUNDLE_KIND_RAW) {
+            text.assign(reinterpret_cast<const char*>(assetBundle.data(*packed)), packed->size);
+        } else {
+            std::ifstream disk(textPath);
+            if (!disk.is_open()) {
+                std::cerr << "❌ Không mở được tệp: " << textPath << std::endl;
+                return false;
+            }
+            std::stringstream buffer;
+            buffer << disk.rdbuf();
+            text = buffer.str();
         }
-        row++;
+        if (!parseLevelText(text, level, textPath)) return false;
     }
-    if (row != MAP_HEIGHT) {
-        std::cerr << "❌ Số hàng không hợp lệ trong " << filePath << std::endl;
-        file.close();
-        return false;
-    }
-    file.close();
     return true;
 }
 
-SDL_Rect getAttackRect(SDL_Rect playerRect, float cameraX, bool facingLeft) {
-    SDL_Rect attackRect = playerRect;
-    attackRect.x -= static_cast<int>(cameraX);
-    attackRect.w = 10;
-    attackRect.h = playerRect.h / 2;
-    if (facingLeft) attackRect.x -= 30;
-    else attackRect.x += playerRect.w + 5;
-    return attackRect;
-}
-
-SDL_Rect getEnemyAttackRect(const Enemy& enemy) {
-    SDL_Rect attackRect = { static_cast<int>(enemy.x), static_cast<int>(enemy.y), 100, 64 };
-    if (enemy.movingRight) {
-        attackRect.x += 20;
-    } else {
-        attackRect.x -= 100;
-    }
-    return attackRect;
-}
-
-SDL_Rect getNewEnemyAttackRect(const NewEnemy& newEnemy) {
-    SDL_Rect attackRect = { static_cast<int>(newEnemy.x), static_cast<int>(newEnemy.y), 40, 40 };
-    if (newEnemy.movingRight) {
-        attackRect.x += 15;
-    } else {
-        attackRect.x -= 60;
-    }
-    return attackRect;
-}
-
-SDL_Rect getBossAttackRect(const Boss& boss) {
-    int newWidth = static_cast<int>(60 * boss.scale);
-    int newHeight = static_cast<int>(60 * boss.scale);
-    SDL_Rect attackRect = { static_cast<int>(boss.x), static_cast<int>(boss.y), newWidth, newHeight };
-    if (boss.movingRight) {
-        attackRect.x += static_cast<int>(15 * boss.scale);
-    } else {
-        attackRect.x -= static_cast<int>(60 * boss.scale);
-    }
-    return attackRect;
+// Đầu vào cố định cho chế độ headless: chạy sang phải, nhảy và chém đều đặn để đi hết level
+void headlessInput(Player& player, long long tick) {
+    if (player.isDying) return;
+    if (tick % 25 == 0) player.attack();
+    else player.moveRight();
+    if (tick % 40 == 0) player.jump();
 }
 
-void initializeLevel(SDL_Renderer* renderer, const int (&levelMap)[MAP_HEIGHT][MAP_WIDTH],
-                     std::vector<Platform>& platforms, std::vector<Enemy>& enemies,
-                     std::vector<NewEnemy>& newEnemies, std::vector<NewEnemy5>& newEnemies5,
-                     std::vector<Boss>& bosses, std::vector<Door>& doors,
-                     std::vector<Item>& items, Player& player, TextureManager& textureManager) {
-    for (auto& platform : platforms) platform.cleanup();
-    platforms.clear();
-    for (auto& enemy : enemies) enemy.cleanup();
-    enemies.clear();
-    for (auto& newEnemy : newEnemies) newEnemy.cleanup();
-    newEnemies.clear();
-    for (auto& newEnemy5 : newEnemies5) newEnemy5.cleanup();
-    newEnemies5.clear();
-    for (auto& boss : bosses) boss.cleanup();
-    bosses.clear();
-    for (auto& door : doors) door.cleanup();
-    doors.clear();
-    for (auto& item : items) item.cleanup();
-    items.clear();
-
-    for (int i = 0; i < MAP_HEIGHT; i++) {
-        for (int j = 0; j < MAP_WIDTH; j++) {
-            if (levelMap[i][j] == 1 || levelMap[i][j] == 3) {
-                Platform platform;
-                platform.init(renderer, j * TILE_WIDTH, i * TILE_HEIGHT, levelMap[i][j], textureManager);
-                platforms.push_back(platform);
-            } else if (levelMap[i][j] == 6) {
-                Door door;
-                door.init(renderer, j * TILE_WIDTH, i * TILE_HEIGHT, textureManager);
-                doors.push_back(door);
-            } else if (levelMap[i][j] == 7) {
-                Item item;
-                item.init(renderer, j * TILE_WIDTH, i * TILE_HEIGHT);
-                items.push_back(item);
+// Áp dụng các contact theo thứ tự đăng ký: đạn, đòn của người chơi, rồi đòn cận chiến của kẻ địch.
+// Kẻ địch vừa bị chém trong cùng tick thì đòn đang vung của nó không còn tác dụng.
+void resolveCombat(const CombatWorld& combat, Player& player, EntityStore& entities, BulletPool& bulletPool) {
+    for (const auto& contact : combat.contacts) {
+        const CombatBox& hitbox = combat.boxes[contact.hitbox];
+        const CombatBox& hurtbox = combat.boxes[contact.hurtbox];
+        size_t i = hitbox.index;
+        if (hurtbox.owner == OWNER_PLAYER) {
+            if (hitbox.owner == OWNER_BULLET) {
+                Bullet& bullet = bulletPool.get(hitbox.index);
+                bullet.toRemove = true;
+                // Tra kẻ địch đã bắn qua handle: đạn của kẻ địch đã bị xóa không còn gây sát thương
+                if (entities.enemies.rowOf(bullet.owner) < 0) continue;
+            } else if (hitbox.owner == OWNER_ENEMY) {
+                if (entities.enemies.isDying[i] || entities.enemies.isHurt[i]) continue;
+                entities.enemies.attackCooldown[i] = Enemy::attackCooldownMax;
+            } else if (hitbox.owner == OWNER_NEW_ENEMY) {
+                if (entities.newEnemies.isDying[i] || entities.newEnemies.isHurt[i]) continue;
+                entities.newEnemies.attackCooldown[i] = NewEnemy::attackCooldownMax;
+            } else if (hitbox.owner == OWNER_BOSS) {
+                if (entities.bosses.isDying[i] || entities.bosses.isHurt[i]) continue;
+                entities.bosses.attackCooldown[i] = Boss::attackCooldownMax;
             }
-        }
-    }
-
-    for (int i = 0; i < MAP_HEIGHT; i++) {
-        int j = 0;
-        while (j < MAP_WIDTH) {
-            if (levelMap[i][j] == 2 || levelMap[i][j] == 4 || levelMap[i][j] == 5 || levelMap[i][j] == 8) {
-                int enemyType = levelMap[i][j];
-                int start_col = j;
-                while (j < MAP_WIDTH && levelMap[i][j] == enemyType) j++;
-                int end_col = j - 1;
-                float min_x = start_col * TILE_WIDTH;
-                float max_x = (end_col + 1) * TILE_WIDTH;
-
-                int foundPlatformRow = -1;
-                for (int row = i + 1; row < MAP_HEIGHT; row++) {
-                    bool hasPlatform = false;
-                    for (int col = start_col; col <= end_col; col++) {
-                        if (levelMap[row][col] == 1 || levelMap[row][col] == 3) {
-                            hasPlatform = true;
-                            break;
-                        }
-                    }
-                    if (hasPlatform) {
-                        foundPlatformRow = row;
-                        break;
-                    }
-                }
-
-                if (foundPlatformRow == -1) {
-                    std::cerr << "Không tìm thấy nền tảng bên dưới kẻ địch ở hàng " << i << std::endl;
-                    continue;
-                }
-
-                float y = foundPlatformRow * TILE_HEIGHT - 64;
-                float start_x = min_x;
-                if (enemyType == 4 || enemyType == 8) {
-                    y -= 35;
-                }
-
-                if (enemyType == 2) {
-                    Enemy enemy;
-                    enemy.init(renderer, start_x, y, min_x, max_x);
-                    enemies.push_back(enemy);
-                } else if (enemyType == 4) {
-                    NewEnemy newEnemy;
-                    newEnemy.init(renderer, start_x, y, min_x, max_x);
-                    newEnemies.push_back(newEnemy);
-                } else if (enemyType == 5) {
-                    NewEnemy5 newEnemy5;
-                    newEnemy5.init(renderer, start_x, y, min_x, max_x);
-                    newEnemies5.push_back(newEnemy5);
-                } else if (enemyType == 8) {
-                    Boss boss;
-                    boss.init(renderer, start_x, y, min_x, max_x);
-                    bosses.push_back(boss);
-                }
-            } else {
-                j++;
+            player.health -= hitbox.damage;
+            std::cout << COMBAT_OWNER_NAMES[hitbox.owner];
+            if (hitbox.owner == OWNER_BULLET) std::cout << " from Enemy #" << bulletPool.get(hitbox.index).owner.slot;
+            std::cout << " hit player, health: " << player.health << std::endl;
+            if (player.health <= 0 && !player.isDying) {
+                player.isDying = true;
+                player.currentFrame = 0;
+                player.deadFrameTimer = 0;
             }
+        } else if (hurtbox.owner == OWNER_ENEMY) {
+            Enemy::takeHit(entities.enemies, hurtbox.index);
+        } else if (hurtbox.owner == OWNER_NEW_ENEMY) {
+            NewEnemy::takeHit(entities.newEnemies, hurtbox.index);
+        } else if (hurtbox.owner == OWNER_NEW_ENEMY5) {
+            NewEnemy5::hit(entities.newEnemies5, hurtbox.index);
+        } else if (hurtbox.owner == OWNER_BOSS) {
+            Boss::takeHit(entities.bosses, hurtbox.index, hitbox.damage);
         }
     }
+}
+
+// Đưa người chơi và camera về đầu level của world (world đã được dựng xong)
+void enterLevel(World& world, Player& player, Camera& camera, TextureManager& textureManager, BulletPool& bulletPool) {
+    const LevelData& level = *world.level;
+    levelWidthPixels = level.width * TILE_WIDTH;
+    camera.init(level.width);
+    world.streamer.update(camera.x);
 
     player.x = 2 * TILE_WIDTH;
     player.y = 2 * TILE_HEIGHT - 85;
@@ -218,26 +184,80 @@ void initializeLevel(SDL_Renderer* renderer, const int (&levelMap)[MAP_HEIGHT][M
     player.currentFrame = 0;
     player.lives = 3;
     player.health = player.maxHealth;
+    storePrevious(player);
+    storePrevious(camera);
+
+    int platformTiles, platformSpans;
+    countPlatformSpans(level, platformTiles, platformSpans);
+    std::cout << "Platforms: " << platformTiles << " tiles -> " << platformSpans << " spans" << std::endl;
+    textureManager.printStats();
+    bulletPool.printStats();
+    world.streamer.printStats();
 }
 
-void renderBackground(SDL_Renderer* renderer, SDL_Texture* mapTexture, float cameraX, int mapWidthPixels) {
+void renderBackground(SDL_Renderer* renderer, const TextureHandle& mapTexture, float cameraX, int mapWidthPixels) {
     int backgroundWidth = SCREEN_WIDTH;
     int numRepeats = 8;
 
     for (int i = 0; i < numRepeats; i++) {
         int bgX = (i * backgroundWidth) - static_cast<int>(cameraX) % backgroundWidth;
         SDL_Rect dstRect = { bgX, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
-        SDL_RenderCopy(renderer, mapTexture, NULL, &dstRect);
+        renderCopy(renderer, mapTexture, NULL, &dstRect);
     }
 }
 
 
 
 int main(int argc, char* argv[]) {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
+    size_t vramBudget = TEXTURE_VRAM_BUDGET;
+    bool devMode = false;
+    bool headless = false;
+    long long headlessTicks = HEADLESS_DEFAULT_TICKS;
+    std::string recordPath;
+    std::string replayPath;
+    std::string profilePath;
+    int jobWorkers = -1;
+    std::string firstLevel = "level1";
+    uint32_t seed = static_cast<uint32_t>(SDL_GetPerformanceCounter());
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 14, "--vram-budget=") == 0) {
+            vramBudget = static_cast<size_t>(std::atol(arg.c_str() + 14)) * 1024 * 1024;
+        } else if (arg == "--no-bake") {
+            bakeStaticLayer = false;
+        } else if (arg == "--dev") {
+            devMode = true;
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg.compare(0, 11, "--headless=") == 0) {
+            headless = true;
+            headlessTicks = std::atoll(arg.c_str() + 11);
+        } else if (arg.compare(0, 9, "--record=") == 0) {
+            recordPath = arg.substr(9);
+        } else if (arg.compare(0, 9, "--replay=") == 0) {
+            replayPath = arg.substr(9);
+        } else if (arg.compare(0, 7, "--seed=") == 0) {
+            seed = static_cast<uint32_t>(std::strtoul(arg.c_str() + 7, nullptr, 10));
+        } else if (arg.compare(0, 7, "--jobs=") == 0) {
+            jobWorkers = std::max(0, std::atoi(arg.c_str() + 7));
+        } else if (arg.compare(0, 10, "--profile=") == 0) {
+            profilePath = arg.substr(10);
+        } else if (arg.compare(0, 8, "--level=") == 0) {
+            firstLevel = arg.substr(8);
+        } else if (arg.compare(0, 7, "--simd=") == 0) {
+            if (!selectPatrolKernel(arg.substr(7))) {
+                std::cerr << "❌ Không dùng được kernel " << arg.substr(7) << ", giữ "
+                          << PATROL_KERNEL_NAMES[patrolKernel] << std::endl;
+            }
+        }
+    }
+
+    // Headless: không cửa sổ, renderer hay âm thanh; chỉ chạy logic nhanh nhất có thể
+    if (SDL_Init(headless ? 0 : SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         std::cerr << "❌ Khởi tạo SDL thất bại: " << SDL_GetError() << std::endl;
         return 1;
     }
+    profiler.init();
     if (IMG_Init(IMG_INIT_PNG) != IMG_INIT_PNG) {
         std::cerr << "❌ Khởi tạo IMG thất bại: " << IMG_GetError() << std::endl;
         SDL_Quit();
@@ -249,7 +269,7 @@ int main(int argc, char* argv[]) {
         SDL_Quit();
         return 1;
     }
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+    if (!headless && Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
         std::cerr << "❌ Khởi tạo Mix thất bại: " << Mix_GetError() << std::endl;
         TTF_Quit();
         IMG_Quit();
@@ -257,31 +277,49 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    SDL_Window* window = SDL_CreateWindow("Legacy Fantacy Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
-    if (!window) {
-        std::cerr << "❌ Tạo cửa sổ thất bại: " << SDL_GetError() << std::endl;
-        Mix_CloseAudio();
-        TTF_Quit();
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (!renderer) {
-        std::cerr << "❌ Tạo renderer thất bại: " << SDL_GetError() << std::endl;
-        SDL_DestroyWindow(window);
-        Mix_CloseAudio();
-        TTF_Quit();
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    if (!headless) {
+        window = SDL_CreateWindow("Legacy Fantacy Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+        if (!window) {
+            std::cerr << "❌ Tạo cửa sổ thất bại: " << SDL_GetError() << std::endl;
+            Mix_CloseAudio();
+            TTF_Quit();
+            IMG_Quit();
+            SDL_Quit();
+            return 1;
+        }
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (!renderer) {
+            std::cerr << "❌ Tạo renderer thất bại: " << SDL_GetError() << std::endl;
+            SDL_DestroyWindow(window);
+            Mix_CloseAudio();
+            TTF_Quit();
+            IMG_Quit();
+            SDL_Quit();
+            return 1;
+        }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
     }
 
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    if (assetBundle.open(ASSETS_PATH + "assets.bundle")) {
+        std::cout << "Bundle: " << assetBundle.header->entryCount << " assets" << std::endl;
+    }
 
-    SDL_Texture* mapTexture = IMG_LoadTexture(renderer, (ASSETS_PATH + "map.png").c_str());
-    if (!mapTexture) {
-        std::cerr << "❌ Không tải được map.png: " << IMG_GetError() << std::endl;
+    TextureManager textureManager;
+    textureManager.init(renderer, vramBudget);
+
+    AssetLoader assetLoader;
+    assetLoader.init(headless ? 0 : std::max(1, std::min(4, SDL_GetCPUCount() - 1)));
+    std::vector<std::string> startupAssets = { ASSETS_PATH + "map.png", ASSETS_PATH + "menu.png", ASSETS_PATH + "heart.png" };
+    Player::listAssets(startupAssets);
+    assetLoader.requestAll(startupAssets, textureManager);
+    assetLoader.finish(textureManager);
+
+    TextureHandle mapTexture = textureManager.acquire(ASSETS_PATH + "map.png");
+    if (!headless && !mapTexture.get()) {
+        assetLoader.cleanup();
+        textureManager.cleanup();
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         Mix_CloseAudio();
@@ -291,10 +329,11 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    Mix_Music* backgroundMusic = Mix_LoadMUS((ASSETS_PATH + "backgroundmusic.mp3").c_str());
-    if (!backgroundMusic) {
+    Mix_Music* backgroundMusic = headless ? nullptr : Mix_LoadMUS_RW(openAsset(ASSETS_PATH + "backgroundmusic.mp3"), 1);
+    if (!headless && !backgroundMusic) {
         std::cerr << "❌ Không tải được backgroundmusic.mp3: " << Mix_GetError() << std::endl;
-        SDL_DestroyTexture(mapTexture);
+        assetLoader.cleanup();
+        textureManager.cleanup();
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         Mix_CloseAudio();
@@ -304,13 +343,12 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    SDL_Texture* startScreenTexture = IMG_LoadTexture(renderer, (ASSETS_PATH + "menu.png").c_str());
-    if (!startScreenTexture) std::cerr << "❌ Không tải được menu.png: " << IMG_GetError() << std::endl;
+    TextureHandle startScreenTexture = textureManager.acquire(ASSETS_PATH + "menu.png");
 
-    TTF_Font* titleFont = TTF_OpenFont((ASSETS_PATH + "Legacy.ttf").c_str(), 54);
+    TTF_Font* titleFont = TTF_OpenFontRW(openAsset(ASSETS_PATH + "Legacy.ttf"), 1, 54);
     if (!titleFont) std::cerr << "❌ Không tải được Legacy.ttf: " << TTF_GetError() << std::endl;
 
-    TTF_Font* startFont = TTF_OpenFont((ASSETS_PATH + "PixelFont.ttf").c_str(), 30);
+    TTF_Font* startFont = TTF_OpenFontRW(openAsset(ASSETS_PATH + "PixelFont.ttf"), 1, 30);
     if (!startFont) std::cerr << "❌ Không tải được PixelFont.ttf: " << TTF_GetError() << std::endl;
 
     SDL_Color yellow = {255, 255, 0, 255};
@@ -324,19 +362,17 @@ int main(int argc, char* argv[]) {
     SDL_Rect startRect = startSurface ? SDL_Rect{0, 0, startSurface->w, startSurface->h} : SDL_Rect{0, 0, 0, 0};
     if (startSurface) SDL_FreeSurface(startSurface);
 
-    SDL_Texture* heartTexture = IMG_LoadTexture(renderer, (ASSETS_PATH + "heart.png").c_str());
-    if (!heartTexture) std::cerr << "❌ Không tải được heart.png: " << IMG_GetError() << std::endl;
+    TextureHandle heartTexture = textureManager.acquire(ASSETS_PATH + "heart.png");
 
-    int level1Map[MAP_HEIGHT][MAP_WIDTH];
-    int level2Map[MAP_HEIGHT][MAP_WIDTH];
-    if (!loadLevelMap(ASSETS_PATH + "level1.dat", level1Map) || !loadLevelMap(ASSETS_PATH + "level2.dat", level2Map)) {
+    LevelData level1Map;
+    LevelData level2Map;
+    if (!loadLevel(firstLevel, level1Map) || !loadLevel("level2", level2Map)) {
         std::cerr << "❌ Không tải được level map. Thoát..." << std::endl;
         Mix_FreeMusic(backgroundMusic);
-        SDL_DestroyTexture(mapTexture);
-        SDL_DestroyTexture(startScreenTexture);
+        assetLoader.cleanup();
+        textureManager.cleanup();
         SDL_DestroyTexture(titleTexture);
         SDL_DestroyTexture(startTexture);
-        SDL_DestroyTexture(heartTexture);
         if (titleFont) TTF_CloseFont(titleFont);
         if (startFont) TTF_CloseFont(startFont);
         SDL_DestroyRenderer(renderer);
@@ -348,292 +384,281 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    std::vector<std::string> levelAssets;
+    collectLevelAssets(level1Map, levelAssets);
+    assetLoader.requestAll(levelAssets, textureManager);
+
     Camera camera;
-    camera.init(MAP_WIDTH);
 
-    TextureManager textureManager;
-    textureManager.init(renderer);
-
-    std::vector<Platform> platforms;
-    std::vector<Enemy> enemies;
-    std::vector<NewEnemy> newEnemies;
-    std::vector<NewEnemy5> newEnemies5;
-    std::vector<Boss> bosses;
-    std::vector<Door> doors;
-    std::vector<Item> items;
+    BulletPool bulletPool;
+    bulletPool.init(textureManager);
+
+    World world;
+    LevelPrefetcher prefetcher;
     Player player;
-    player.init(renderer, 0, 0);
+    player.init(renderer, 0, 0, textureManager);
 
     Transition transition;
     transition.init();
 
-    initializeLevel(renderer, level1Map, platforms, enemies, newEnemies, newEnemies5, bosses, doors, items, player, textureManager);
+    assetLoader.finish(textureManager);
+    world.begin(renderer, level1Map, textureManager);
+    world.buildSome(renderer, textureManager, world.totalToBuild());
+    enterLevel(world, player, camera, textureManager, bulletPool);
+
+    LevelWatcher levelWatcher;
+    std::vector<std::string> changedLevels;
+    if (devMode && levelWatcher.init(ASSETS_PATH, { firstLevel + ".dat", "level2.dat" })) {
+        std::cout << "Dev: watching " << ASSETS_PATH << firstLevel << ".dat, level2.dat" << std::endl;
+    }
+
+    // Có vsync thì SDL_RenderPresent tự chờ màn hình; không có thì nhường CPU một chút mỗi frame
+    SDL_RendererInfo rendererInfo;
+    bool vsync = SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    FixedTimestep timestep;
+    timestep.init();
+    Interpolator interpolator;
+    CombatWorld combat;
+    // Một worker mỗi lõi còn lại; --jobs=0 chạy mọi thứ trên luồng chính
+    JobSystem jobs;
+    jobs.init(jobWorkers >= 0 ? jobWorkers : std::max(0, SDL_GetCPUCount() - 1));
+    std::vector<SpatialHit> spatialHits;
+    std::vector<uint32_t> nearbyItems;
+    Uint64 runStart = SDL_GetPerformanceCounter();
+
+    InputRecorder recorder;
+    InputReplayer replayer;
+    if (!replayPath.empty() && replayer.load(replayPath)) {
+        seed = replayer.header.seed;
+        headlessTicks = static_cast<long long>(replayer.header.tickCount);
+        std::cout << "Replay: " << replayPath << ", " << replayer.header.tickCount << " ticks, seed " << seed << std::endl;
+    } else if (!recordPath.empty()) {
+        recorder.start(recordPath, seed);
+    }
+    seedRandom(seed);
+    // Ghi/phát lại: đợi tải xong ở màn hình đen thay vì phụ thuộc tốc độ luồng tải
+    bool deterministic = recorder.isActive() || replayer.isActive();
+
+    if (headless) {
+        // Có replay thì input lấy từ file; không thì dùng headlessInput và bắt đầu chơi ngay
+        if (!replayer.isActive()) isGameStarted = true;
+        std::cout << "Headless: simulating " << headlessTicks << " ticks" << std::endl;
+    }
 
     SDL_Event event;
     bool running = true;
+    auto handleKey = [&](SDL_Keycode key, bool down) {
+        if (down) {
+            bool isAnyEndScreen = world.entities.endScreenIndex() >= 0;
+            if (isAnyEndScreen && key == SDLK_s) {
+                running = false;
+            } else if (!isGameStarted && key == SDLK_s) {
+                isGameStarted = true;
+                if (!musicStarted && backgroundMusic) {
+                    Mix_PlayMusic(backgroundMusic, -1);
+                    musicStarted = true;
+                }
+            }
+            if (isGameStarted && !transition.isTransitioning && !player.isDying) {
+                switch (key) {
+                    case SDLK_LEFT: player.moveLeft(); break;
+                    case SDLK_RIGHT: player.moveRight(); break;
+                    case SDLK_UP: player.jump(); break;
+                    case SDLK_d: player.attack(); break;
+                }
+            }
+        } else if (isGameStarted) {
+            switch (key) {
+                case SDLK_LEFT:
+                    player.isMovingLeft = false;
+                    if (!player.isMovingLeft && !player.isMovingRight) player.stop();
+                    break;
+                case SDLK_RIGHT:
+                    player.isMovingRight = false;
+                    if (!player.isMovingLeft && !player.isMovingRight) player.stop();
+                    break;
+            }
+        }
+    };
+
     while (running) {
+        PROFILE_BEGIN(eventScope, "SDL_PollEvent");
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) running = false;
-            if (event.type == SDL_KEYDOWN) {
-                bool isAnyEndScreen = false;
-                for (const auto& newEnemy5 : newEnemies5) {
-                    if (newEnemy5.isEndScreen) {
-                        isAnyEndScreen = true;
-                        break;
-                    }
-                }
-                if (isAnyEndScreen && event.key.keysym.sym == SDLK_s) {
-                    running = false;
-                } else if (!isGameStarted && event.key.keysym.sym == SDLK_s) {
-                    isGameStarted = true;
-                    if (!musicStarted) {
-                        Mix_PlayMusic(backgroundMusic, -1);
-                        musicStarted = true;
-                    }
-                }
-                if (isGameStarted && !transition.isTransitioning && !player.isDying) {
-                    switch (event.key.keysym.sym) {
-                        case SDLK_LEFT: player.moveLeft(); break;
-                        case SDLK_RIGHT: player.moveRight(); break;
-                        case SDLK_UP: player.jump(); break;
-                        case SDLK_d: player.attack(); break;
-                    }
-                }
+            if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+                world.streamer.rebake();
+                prefetcher.world.streamer.rebake();
             }
-            if (event.type == SDL_KEYUP && isGameStarted) {
-                switch (event.key.keysym.sym) {
-                    case SDLK_LEFT:
-                        player.isMovingLeft = false;
-                        if (!player.isMovingLeft && !player.isMovingRight) player.stop();
-                        break;
-                    case SDLK_RIGHT:
-                        player.isMovingRight = false;
-                        if (!player.isMovingLeft && !player.isMovingRight) player.stop();
-                        break;
-                }
+            if (event.type == SDL_KEYDOWN && profiler.handleKey(event.key.keysym.sym)) continue;
+            // Khi phát lại, bàn phím bị bỏ qua; phím được đưa vào từ file theo đúng tick
+            if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && !replayer.isActive()) {
+                bool down = event.type == SDL_KEYDOWN;
+                if (recorder.isActive()) recorder.record(timestep.ticks, event.key.keysym.sym, down);
+                handleKey(event.key.keysym.sym, down);
             }
         }
+        PROFILE_END(eventScope);
 
-        if (isGameStarted) {
-            if (!transition.isTransitioning) {
-                player.update(platforms);
-                if (player.shouldQuit) {
-                    running = false;
-                }
-                camera.update(player.x);
-                for (auto& enemy : enemies) {
-                    enemy.update(player.x, player.y, textureManager, renderer);
-                    for (auto& bullet : enemy.bullets) {
-                        bullet.update();
-                        SDL_Rect bulletRect = { static_cast<int>(bullet.x), static_cast<int>(bullet.y), bullet.width, bullet.height };
-                        SDL_Rect playerRect = { static_cast<int>(player.x), static_cast<int>(player.y), player.rect.w, player.rect.h };
-                        if (SDL_HasIntersection(&bulletRect, &playerRect)) {
-                            player.health -= 10;
-                            bullet.toRemove = true;
-                            std::cout << "Bullet hit player, health: " << player.health << std::endl;
-                            if (player.health <= 0 && !player.isDying) {
-                                player.isDying = true;
-                                player.currentFrame = 0;
-                                player.deadFrameTimer = 0;
-                            }
-                        }
-                    }
-                }
-                for (auto& newEnemy : newEnemies) newEnemy.update(player.x, player.y);
-                for (auto& newEnemy5 : newEnemies5) newEnemy5.update();
-                for (auto& boss : bosses) boss.update(player.x, player.y, camera);
-
-                for (auto& item : items) {
-                    if (!item.isCollected && SDL_HasIntersection(&player.rect, &item.rect)) {
-                        item.isCollected = true;
-                        player.health += 10;
-                        if (player.health > player.maxHealth) {
-                            player.health = player.maxHealth;
-                        }
-                        std::cout << "Player collected item, health: " << player.health << std::endl;
-                    }
-                }
+        levelWatcher.poll(changedLevels);
+        for (const auto& changed : changedLevels) {
+            if (changed == firstLevel + ".dat") hotReloadLevel(firstLevel, level1Map, world, prefetcher, camera, renderer, textureManager, bulletPool);
+            if (changed == "level2.dat") hotReloadLevel("level2", level2Map, world, prefetcher, camera, renderer, textureManager, bulletPool);
+        }
 
-                for (const auto& door : doors) {
-                    if (SDL_HasIntersection(&player.rect, &door.rect)) {
-                        transition.start(2);
-                        break;
+        int ticks = headless ? timestep.advanceFixed(static_cast<int>(std::min<long long>(HEADLESS_TICKS_PER_FRAME, headlessTicks - timestep.ticks)))
+                             : timestep.advance();
+        int tick = 0;
+        for (; tick < ticks && running; tick++) {
+            long long currentTick = timestep.ticks - ticks + tick;
+            if (replayer.isActive()) replayer.play(currentTick, handleKey);
+            else if (headless && !transition.isTransitioning) headlessInput(player, currentTick);
+            storePrevious(player);
+            storePrevious(camera);
+            world.entities.storePrevious(bulletPool);
+
+            if (isGameStarted) {
+                if (!transition.isTransitioning) {
+                    PROFILE_BEGIN(updateScope, "update");
+                    player.update(world.collision);
+                    if (player.shouldQuit) {
+                        running = false;
                     }
-                }
-
-                if (player.isAttacking) {
-                    SDL_Rect attackRect = getAttackRect(player.rect, camera.x, player.facingLeft);
-                    for (auto& enemy : enemies) {
-                        if (enemy.isDying || enemy.isHurt) continue;
-                        SDL_Rect enemyRect = { static_cast<int>(enemy.x - camera.x), static_cast<int>(enemy.y), 64, 64 };
-                        if (SDL_HasIntersection(&attackRect, &enemyRect)) {
-                            enemy.isHurt = true;
-                            enemy.currentFrame = 0;
-                            enemy.hitCount++;
-                            if (enemy.hitCount >= 2) {
-                                enemy.isHurt = false;
-                                enemy.isDying = true;
-                                enemy.currentFrame = 0;
-                            }
-                        }
+                    camera.update(player.x);
+                    world.streamer.update(camera.x);
+                    EntityStore& entities = world.entities;
+                    entities.update(player.x, player.y, camera, bulletPool, jobs);
+                    world.updateSpatial(bulletPool);
+
+                    // Chỉ xét vật phẩm trong các ô quanh người chơi; xử lý theo thứ tự chỉ số như vòng lặp cũ
+                    spatialHits.clear();
+                    world.spatial.queryRect({ static_cast<float>(player.rect.x), static_cast<float>(player.rect.y),
+                                              static_cast<float>(player.rect.w), static_cast<float>(player.rect.h) }, spatialHits);
+                    nearbyItems.clear();
+                    for (const auto& hit : spatialHits) {
+                        if (hit.kind == SPATIAL_ITEM) nearbyItems.push_back(hit.index);
                     }
-                    for (auto& newEnemy : newEnemies) {
-                        if (newEnemy.isDying || newEnemy.isHurt) continue;
-                        SDL_Rect newEnemyRect = { static_cast<int>(newEnemy.x - camera.x), static_cast<int>(newEnemy.y), 64, 64 };
-                        if (SDL_HasIntersection(&attackRect, &newEnemyRect)) {
-                            newEnemy.isHurt = true;
-                            newEnemy.currentFrame = 0;
-                            newEnemy.hitCount++;
-                            if (newEnemy.hitCount >= 3) {
-                                newEnemy.isHurt = false;
-                                newEnemy.isDying = true;
-                                newEnemy.currentFrame = 0;
+                    std::sort(nearbyItems.begin(), nearbyItems.end());
+                    for (uint32_t index : nearbyItems) {
+                        Item& item = world.items[index];
+                        if (!item.isCollected && SDL_HasIntersection(&player.rect, &item.rect)) {
+                            item.isCollected = true;
+                            world.spatial.remove(item.spatialId);
+                            item.spatialId = SPATIAL_NONE;
+                            player.health += 10;
+                            if (player.health > player.maxHealth) {
+                                player.health = player.maxHealth;
                             }
+                            std::cout << "Player collected item, health: " << player.health << std::endl;
                         }
                     }
-                    for (auto& newEnemy5 : newEnemies5) {
-                        if (newEnemy5.isHit) continue;
-                        SDL_Rect newEnemy5Rect = { static_cast<int>(newEnemy5.x - camera.x), static_cast<int>(newEnemy5.y), 64, 64 };
-                        if (SDL_HasIntersection(&attackRect, &newEnemy5Rect)) {
-                            newEnemy5.hit();
+
+                    for (const auto& door : world.doors) {
+                        if (std::abs(door.rect.x - player.x) < PREFETCH_DOOR_DISTANCE) {
+                            prefetcher.start(2, level2Map, assetLoader, textureManager);
                         }
-                    }
-                    for (auto& boss : bosses) {
-                        if (boss.isDying || boss.isHurt) continue;
-                        SDL_Rect bossRect = { static_cast<int>(boss.x - camera.x), static_cast<int>(boss.y), static_cast<int>(288 * boss.scale), static_cast<int>(118 * boss.scale) };
-                        if (SDL_HasIntersection(&attackRect, &bossRect)) {
-                            boss.health -= 5; // Giảm 5 máu khi bị tấn công
-                            boss.isHurt = true;
-                            boss.currentFrame = 0;
-                            std::cout << "Player hit boss, boss health: " << boss.health << std::endl;
+                        if (SDL_HasIntersection(&player.rect, &door.rect)) {
+                            prefetcher.start(2, level2Map, assetLoader, textureManager);
+                            transition.start(2);
+                            break;
                         }
                     }
-                }
 
-                for (auto& enemy : enemies) {
-                    if (enemy.isAttacking && !enemy.isDying && !enemy.isHurt && enemy.attackCooldown <= 0) {
-                        SDL_Rect enemyAttackRect = getEnemyAttackRect(enemy);
-                        SDL_Rect playerRect = { static_cast<int>(player.x), static_cast<int>(player.y), player.rect.w, player.rect.h };
-                        if (SDL_HasIntersection(&enemyAttackRect, &playerRect)) {
-                            player.health -= 15;
-                            enemy.attackCooldown = enemy.attackCooldownMax;
-                            std::cout << "Enemy hit player, health: " << player.health << std::endl;
-                            if (player.health <= 0 && !player.isDying) {
-                                player.isDying = true;
-                                player.currentFrame = 0;
-                                player.deadFrameTimer = 0;
-                            }
-                        }
-                    }
-                }
+                    PROFILE_END(updateScope);
 
-                for (auto& newEnemy : newEnemies) {
-                    if (newEnemy.isAttacking && !newEnemy.isDying && !newEnemy.isHurt && newEnemy.attackCooldown <= 0) {
-                        SDL_Rect newEnemyAttackRect = getNewEnemyAttackRect(newEnemy);
-                        SDL_Rect playerRect = { static_cast<int>(player.x), static_cast<int>(player.y), player.rect.w, player.rect.h };
-                        if (SDL_HasIntersection(&newEnemyAttackRect, &playerRect)) {
-                            player.health -= 20;
-                            newEnemy.attackCooldown = newEnemy.attackCooldownMax;
-                            std::cout << "NewEnemy hit player, health: " << player.health << std::endl;
-                            if (player.health <= 0 && !player.isDying) {
-                                player.isDying = true;
-                                player.currentFrame = 0;
-                                player.deadFrameTimer = 0;
-                            }
-                        }
-                    }
+                    PROFILE_SCOPE("combat");
+                    combat.clear();
+                    entities.publishBullets(combat, bulletPool);
+                    player.publishBoxes(combat);
+                    entities.publishBoxes(combat, camera.x);
+                    combat.findContacts();
+                    resolveCombat(combat, player, entities, bulletPool);
+
+                    entities.removeMarked(textureManager, bulletPool, world.spatial);
                 }
 
-                for (auto& boss : bosses) {
-                    if (boss.isAttacking && !boss.isDying && !boss.isHurt && boss.attackCooldown <= 0) {
-                        SDL_Rect bossAttackRect = getBossAttackRect(boss);
-                        SDL_Rect playerRect = { static_cast<int>(player.x), static_cast<int>(player.y), player.rect.w, player.rect.h };
-                        if (SDL_HasIntersection(&bossAttackRect, &playerRect)) {
-                            player.health -= 20;
-                            boss.attackCooldown = boss.attackCooldownMax;
-                            std::cout << "Boss hit player, health: " << player.health << std::endl;
-                            if (player.health <= 0 && !player.isDying) {
-                                player.isDying = true;
-                                player.currentFrame = 0;
-                                player.deadFrameTimer = 0;
-                            }
-                        }
+                assetLoader.pump(textureManager);
+                prefetcher.update(renderer, assetLoader, textureManager);
+                if (transition.update(deterministic || assetLoader.isIdle())) {
+                    if (transition.targetLevel == 2) {
+                        prefetcher.finish(renderer, assetLoader, textureManager);
+                        std::swap(world, prefetcher.world);
+                        prefetcher.reset(textureManager, bulletPool);
+                        enterLevel(world, player, camera, textureManager, bulletPool);
                     }
                 }
-
-                enemies.erase(std::remove_if(enemies.begin(), enemies.end(),
-                    [](const Enemy& e) { return e.toRemove; }), enemies.end());
-                newEnemies.erase(std::remove_if(newEnemies.begin(), newEnemies.end(),
-                    [](const NewEnemy& e) { return e.toRemove; }), newEnemies.end());
-                newEnemies5.erase(std::remove_if(newEnemies5.begin(), newEnemies5.end(),
-                    [](const NewEnemy5& e) { return e.toRemove; }), newEnemies5.end());
-                bosses.erase(std::remove_if(bosses.begin(), bosses.end(),
-                    [](const Boss& b) { return b.toRemove; }), bosses.end());
-            }
-
-            if (transition.update()) {
-                if (transition.targetLevel == 2) {
-                    initializeLevel(renderer, level2Map, platforms, enemies, newEnemies, newEnemies5, bosses, doors, items, player, textureManager);
+            } else {
+                player.frameTimer++;
+                if (player.frameTimer >= player.frameDelay) {
+                    player.frameTimer = 0;
+                    player.currentFrame = (player.currentFrame + 1) % 4;
                 }
             }
-        } else {
-            player.frameTimer++;
-            if (player.frameTimer >= player.frameDelay) {
-                player.frameTimer = 0;
-                player.currentFrame = (player.currentFrame + 1) % 4;
+
+            if (recorder.isActive()) recorder.endTick(currentTick + 1, player, world, bulletPool);
+            if (replayer.isActive()) {
+                replayer.endTick(currentTick + 1, player, world, bulletPool);
+                if (replayer.isFinished(currentTick + 1)) running = false;
             }
         }
 
-        SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
-        SDL_RenderClear(renderer);
+        timestep.ticks -= ticks - tick;   // Thoát giữa chừng: không tính các tick chưa chạy
+
+        if (headless) {
+            if (timestep.ticks >= headlessTicks) running = false;
+            continue;
+        }
 
-        bool isAnyEndScreen = false;
-        for (const auto& newEnemy5 : newEnemies5) {
-            if (newEnemy5.isEndScreen) {
-                isAnyEndScreen = true;
-                break;
+        PROFILE_BEGIN(drawScope, "draw");
+        SDL_Rect playerRect = player.rect;
+        if (isGameStarted) {
+            interpolator.alpha = timestep.alpha();
+            interpolator.apply(camera);
+            interpolator.apply(player);
+            player.rect.x = static_cast<int>(player.x);
+            player.rect.y = static_cast<int>(player.y);
+            interpolator.apply(world.entities.enemies);
+            for (const auto& enemy : world.entities.enemies.cold) {
+                for (int k = 0; k < enemy.bulletCount; k++) interpolator.apply(bulletPool.get(enemy.bulletSlots[k]));
             }
+            interpolator.apply(world.entities.newEnemies);
+            interpolator.apply(world.entities.newEnemies5);
+            interpolator.apply(world.entities.bosses);
         }
 
-        if (isAnyEndScreen) {
-            for (auto& newEnemy5 : newEnemies5) {
-                newEnemy5.render(renderer, camera.x);
+        SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
+        SDL_RenderClear(renderer);
+
+        if (world.entities.endScreenIndex() >= 0) {
+            for (size_t i = 0; i < world.entities.newEnemies5.size(); i++) {
+                NewEnemy5::render(world.entities.newEnemies5, i, renderer, camera.x);
             }
         } else if (isGameStarted) {
             renderBackground(renderer, mapTexture, camera.x, camera.mapWidthPixels);
-            for (auto& door : doors) door.render(renderer, camera.x);
-            for (auto& platform : platforms) platform.render(renderer, camera.x);
-            for (auto& item : items) item.render(renderer, camera.x);
+            world.streamer.render(camera.x);
+            for (auto& item : world.items) item.render(renderer, camera.x);
             player.render(renderer, camera.x);
-            for (auto& enemy : enemies) enemy.render(renderer, camera.x);
-            for (auto& newEnemy : newEnemies) newEnemy.render(renderer, camera.x);
-            for (auto& newEnemy5 : newEnemies5) newEnemy5.render(renderer, camera.x);
-            for (auto& boss : bosses) boss.render(renderer, camera.x);
-            for (auto& enemy : enemies) {
-                for (auto& bullet : enemy.bullets) {
-                    bullet.render(renderer, camera.x);
-                }
-            }
+            world.entities.render(renderer, camera.x, bulletPool);
 
             player.renderHealthBar(renderer);
             int heartWidth = 30;
             int heartHeight = 30;
             for (int i = 0; i < player.lives; i++) {
                 SDL_Rect heartRect = { 10 + i * (heartWidth + 10), 10, heartWidth, heartHeight };
-                SDL_RenderCopy(renderer, heartTexture, NULL, &heartRect);
+                renderCopy(renderer, heartTexture, NULL, &heartRect);
             }
 
-            for (auto& boss : bosses) {
-                boss.renderHealthBar(renderer, camera.x);
+            for (size_t i = 0; i < world.entities.bosses.size(); i++) {
+                Boss::renderHealthBar(world.entities.bosses, i, renderer, camera.x);
             }
 
             transition.render(renderer);
         } else {
-            SDL_RenderCopy(renderer, startScreenTexture, NULL, NULL);
+            renderCopy(renderer, startScreenTexture, NULL, NULL);
             player.rect.x = (SCREEN_WIDTH - player.rect.w) / 2;
             player.rect.y = (SCREEN_HEIGHT - player.rect.h) / 2;
             SDL_Rect srcRect = { (player.currentFrame % 4) * 64, 0, 64, 80 };
-            SDL_RenderCopyEx(renderer, player.idleTexture, &srcRect, &player.rect, 0, NULL, SDL_FLIP_NONE);
+            renderCopy(renderer, player.idleTexture, &srcRect, &player.rect);
 
             titleRect.x = (SCREEN_WIDTH - titleRect.w) / 2;
             titleRect.y = player.rect.y - titleRect.h - 10;
@@ -644,25 +669,56 @@ int main(int argc, char* argv[]) {
             SDL_RenderCopy(renderer, startTexture, NULL, &startRect);
         }
 
+        if (isGameStarted) {
+            interpolator.restore();
+            player.rect = playerRect;
+        }
+        PROFILE_END(drawScope);
+        profiler.renderGraph(renderer);
+
+        PROFILE_BEGIN(presentScope, "SDL_RenderPresent");
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
+        PROFILE_END(presentScope);
+        profiler.endFrame();
+        renderStats.lastTexture = nullptr;
+        renderStats.frames++;
+        textureManager.endFrame();
+        if (!vsync) SDL_Delay(1);
     }
 
-    player.cleanup();
-    for (auto& platform : platforms) platform.cleanup();
-    for (auto& enemy : enemies) enemy.cleanup();
-    for (auto& newEnemy : newEnemies) newEnemy.cleanup();
-    for (auto& newEnemy5 : newEnemies5) newEnemy5.cleanup();
-    for (auto& boss : bosses) boss.cleanup();
-    for (auto& door : doors) door.cleanup();
-    for (auto& item : items) item.cleanup();
+    if (headless) {
+        double seconds = timestep.elapsedSeconds(runStart);
+        std::cout << "Headless: " << timestep.ticks << " ticks in " << seconds << " s = "
+                  << static_cast<long long>(timestep.ticks / std::max(seconds, 1e-9)) << " ticks/s ("
+                  << timestep.ticks / std::max(seconds, 1e-9) / TICK_RATE << "x real time)" << std::endl;
+        std::cout << "Headless: player x=" << player.x << " health=" << player.health << " lives=" << player.lives
+                  << ", enemies left " << world.entities.size() - world.entities.bosses.size()
+                  << ", bosses left " << world.entities.bosses.size() << std::endl;
+    }
+    if (recorder.isActive()) recorder.save();
+    if (!profilePath.empty()) profiler.writeChromeTrace(profilePath);
+    if (replayer.isActive()) replayer.printStats(timestep.ticks);
+    player.cleanup(textureManager);
+    timestep.printStats();
+    combat.printStats();
+    world.spatial.printStats();
+    jobs.printStats();
+    jobs.cleanup();
+    world.streamer.printStats();
+    world.cleanup(textureManager, bulletPool);
+    prefetcher.reset(textureManager, bulletPool);
+    bulletPool.printStats();
+    bulletPool.cleanup(textureManager);
+    assetLoader.cleanup();
+    textureManager.printStats();
+    if (renderStats.frames > 0) {
+        std::cout << "Render: " << renderStats.copies / renderStats.frames << " copies/frame, "
+                  << renderStats.textureSwitches / renderStats.frames << " texture switches/frame" << std::endl;
+    }
     textureManager.cleanup();
-    if (mapTexture) SDL_DestroyTexture(mapTexture);
     if (backgroundMusic) Mix_FreeMusic(backgroundMusic);
-    if (startScreenTexture) SDL_DestroyTexture(startScreenTexture);
     if (titleTexture) SDL_DestroyTexture(titleTexture);
     if (startTexture) SDL_DestroyTexture(startTexture);
-    if (heartTexture) SDL_DestroyTexture(heartTexture);
     if (titleFont) TTF_CloseFont(titleFont);
     if (startFont) TTF_CloseFont(startFont);
     SDL_DestroyRenderer(renderer);
@@ -671,6 +727,11 @@ int main(int argc, char* argv[]) {
     TTF_Quit();
     IMG_Quit();
     SDL_Quit();
+    level1Map.close();
+    level2Map.close();
+    levelWatcher.cleanup();
+    assetBundle.close();
+    profiler.cleanup();
 
     return 0;
 }
@@ -17,11 +17,13 @@ struct Transition {
         targetLevel = level;
     }
 
-    bool update() {
+    // Giữ màn hình đen cho đến khi tài nguyên của level sau sẵn sàng
+    bool update(bool ready = true) {
         if (!isTransitioning) return false;
         fadeAlpha += fadeSpeed;
         if (fadeAlpha >= 255) {
             fadeAlpha = 255;
+            if (!ready) return false;
             isTransitioning = false;
             return true;
         }
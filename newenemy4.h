@@ -1,188 +1,184 @@
+// Kẻ địch cận chiến. Trạng thái nóng nằm trong EntityColumns<NewEnemy>, struct này chỉ là phần cold.
 struct NewEnemy {
-    float x, y;
-    float speed;
-    bool movingRight;
-    float min_x, max_x;
-    SDL_Texture* moveTexture;
-    SDL_Texture* attackTexture;
-    SDL_Texture* dyingTexture;
-    SDL_Texture* hurtTexture;
-    SDL_Texture* idleTexture;
-    int currentFrame;
-    int moveFrameCount;
-    int attackFrameCount;
-    int dyingFrameCount;
-    int hurtFrameCount;
-    int idleFrameCount;
-    int frameDelay;
-    int frameTimer;
-    bool isAttacking;
-    bool isDying;
-    bool toRemove;
-    bool isHurt;
-    bool isIdle;
-    int hitCount;
-    int attackCooldown;
-    int attackCooldownMax;
+    static constexpr int moveFrameCount = 10;
+    static constexpr int attackFrameCount = 11;
+    static constexpr int dyingFrameCount = 12;
+    static constexpr int hurtFrameCount = 4;
+    static constexpr int idleFrameCount = 8;
+    static constexpr int frameDelay = 8;
+    static constexpr int attackCooldownMax = 60;
+    static constexpr int attackDamage = 20;
+    static constexpr int hitsToDie = 3;
 
-    void init(SDL_Renderer* renderer, float start_x, float start_y, float min_x, float max_x) {
-        x = start_x;
-        y = start_y - 10.0f;
-        speed = 1.2f;
-        movingRight = true;
-        this->min_x = min_x;
-        this->max_x = max_x;
+    TextureHandle moveTexture;
+    TextureHandle attackTexture;
+    TextureHandle dyingTexture;
+    TextureHandle hurtTexture;
+    TextureHandle idleTexture;
 
-        std::string movePath = ASSETS_PATH + "newenemy_move_sheet.png";
-        SDL_Surface* moveSurface = IMG_Load(movePath.c_str());
-        moveTexture = moveSurface ? SDL_CreateTextureFromSurface(renderer, moveSurface) : nullptr;
-        if (!moveSurface) std::cerr << "❌ Không tải được " << movePath << ": " << IMG_GetError() << std::endl;
-        if (moveSurface) SDL_FreeSurface(moveSurface);
-
-        std::string attackPath = ASSETS_PATH + "newenemy_attack_sheet.png";
-        SDL_Surface* attackSurface = IMG_Load(attackPath.c_str());
-        attackTexture = attackSurface ? SDL_CreateTextureFromSurface(renderer, attackSurface) : nullptr;
-        if (!attackSurface) std::cerr << "❌ Không tải được " << attackPath << ": " << IMG_GetError() << std::endl;
-        if (attackSurface) SDL_FreeSurface(attackSurface);
-
-        std::string dyingPath = ASSETS_PATH + "newenemy_dying_sheet.png";
-        SDL_Surface* dyingSurface = IMG_Load(dyingPath.c_str());
-        dyingTexture = dyingSurface ? SDL_CreateTextureFromSurface(renderer, dyingSurface) : nullptr;
-        if (!dyingSurface) std::cerr << "❌ Không tải được " << dyingPath << ": " << IMG_GetError() << std::endl;
-        if (dyingSurface) SDL_FreeSurface(dyingSurface);
-
-        std::string hurtPath = ASSETS_PATH + "newenemy_hurt_sheet.png";
-        SDL_Surface* hurtSurface = IMG_Load(hurtPath.c_str());
-        hurtTexture = hurtSurface ? SDL_CreateTextureFromSurface(renderer, hurtSurface) : nullptr;
-        if (!hurtSurface) std::cerr << "❌ Không tải được " << hurtPath << ": " << IMG_GetError() << std::endl;
-        if (hurtSurface) SDL_FreeSurface(hurtSurface);
-
-        std::string idlePath = ASSETS_PATH + "newenemy_Idle_sheet.png";
-        SDL_Surface* idleSurface = IMG_Load(idlePath.c_str());
-        idleTexture = idleSurface ? SDL_CreateTextureFromSurface(renderer, idleSurface) : nullptr;
-        if (!idleSurface) std::cerr << "❌ Không tải được " << idlePath << ": " << IMG_GetError() << std::endl;
-        if (idleSurface) SDL_FreeSurface(idleSurface);
+    static void listAssets(std::vector<std::string>& paths) {
+        paths.push_back(ASSETS_PATH + "newenemy_move_sheet.png");
+        paths.push_back(ASSETS_PATH + "newenemy_attack_sheet.png");
+        paths.push_back(ASSETS_PATH + "newenemy_dying_sheet.png");
+        paths.push_back(ASSETS_PATH + "newenemy_hurt_sheet.png");
+        paths.push_back(ASSETS_PATH + "newenemy_Idle_sheet.png");
+    }
 
-        currentFrame = 0;
-        moveFrameCount = 10;
-        attackFrameCount = 11;
-        dyingFrameCount = 12;
-        hurtFrameCount = 4;
-        idleFrameCount = 8;
-        frameDelay = 8;
-        frameTimer = 0;
-        isAttacking = false;
-        isDying = false;
-        toRemove = false;
-        isHurt = false;
-        isIdle = true;
-        hitCount = 0;
-        attackCooldown = 0;
-        attackCooldownMax = 60;
+    static size_t spawn(EntityColumns<NewEnemy>& columns, float start_x, float start_y, float min_x, float max_x, TextureManager& textureManager) {
+        size_t i = columns.add(start_x, start_y - 10.0f, min_x, max_x, 1.2f);
+        NewEnemy& newEnemy = columns.cold[i];
+        newEnemy.moveTexture = textureManager.acquire(ASSETS_PATH + "newenemy_move_sheet.png");
+        newEnemy.attackTexture = textureManager.acquire(ASSETS_PATH + "newenemy_attack_sheet.png");
+        newEnemy.dyingTexture = textureManager.acquire(ASSETS_PATH + "newenemy_dying_sheet.png");
+        newEnemy.hurtTexture = textureManager.acquire(ASSETS_PATH + "newenemy_hurt_sheet.png");
+        newEnemy.idleTexture = textureManager.acquire(ASSETS_PATH + "newenemy_Idle_sheet.png");
+        return i;
     }
 
-    void update(float playerX, float playerY) {
-        if (isDying) {
-            frameTimer++;
-            if (frameTimer >= frameDelay) {
-                frameTimer = 0;
-                currentFrame++;
-                if (currentFrame >= dyingFrameCount) {
-                    toRemove = true;
-                }
-            }
-        } else if (isHurt) {
-            frameTimer++;
-            if (frameTimer >= frameDelay) {
-                frameTimer = 0;
-                currentFrame++;
-                if (currentFrame >= hurtFrameCount) {
-                    isHurt = false;
-                    currentFrame = 0;
-                    isIdle = true;
-                }
-            }
-        } else {
-            float distance = std::abs(playerX - x);
-            if (!movingRight && distance < 100 && !isAttacking) {
-                isAttacking = true;
-                currentFrame = 0;
-                isIdle = false;
-            }
+    // Cập nhật các hàng [begin, end); con trỏ cột lấy một lần ngoài vòng lặp
+    static void update(EntityColumns<NewEnemy>& columns, size_t begin, size_t end, float playerX, float playerY) {
+        PROFILE_SCOPE("NewEnemy::update");
+        float* xs = columns.x.data();
+        int* currentFrames = columns.currentFrame.data();
+        int* frameTimers = columns.frameTimer.data();
+        int* attackCooldowns = columns.attackCooldown.data();
+        uint8_t* movingRights = columns.movingRight.data();
+        uint8_t* isAttackings = columns.isAttacking.data();
+        uint8_t* isHurts = columns.isHurt.data();
+        const uint8_t* isDyings = columns.isDying.data();
+        uint8_t* isIdles = columns.isIdle.data();
+        uint8_t* toRemoves = columns.toRemove.data();
+        uint8_t* patrols = columns.patrol.data();
+        for (size_t i = begin; i < end; i++) {
+            patrols[i] = false;
+            float& x = xs[i];
+            uint8_t& movingRight = movingRights[i];
+            int& currentFrame = currentFrames[i];
+            int& frameTimer = frameTimers[i];
+            uint8_t& isAttacking = isAttackings[i];
+            uint8_t& isHurt = isHurts[i];
+            uint8_t& isIdle = isIdles[i];
+            int& attackCooldown = attackCooldowns[i];
 
-            if (isAttacking) {
+            if (isDyings[i]) {
+                frameTimer++;
+                if (frameTimer >= frameDelay) {
+                    frameTimer = 0;
+                    currentFrame++;
+                    if (currentFrame >= dyingFrameCount) {
+                        toRemoves[i] = true;
+                    }
+                }
+            } else if (isHurt) {
                 frameTimer++;
                 if (frameTimer >= frameDelay) {
                     frameTimer = 0;
                     currentFrame++;
-                    if (currentFrame >= attackFrameCount) {
-                        isAttacking = false;
+                    if (currentFrame >= hurtFrameCount) {
+                        isHurt = false;
                         currentFrame = 0;
                         isIdle = true;
                     }
                 }
             } else {
-                if (isIdle) {
-                    if (movingRight) {
-                        x += speed;
-                        if (x >= max_x) {
-                            x = max_x;
-                            movingRight = false;
-                        }
-                    } else {
-                        x -= speed;
-                        if (x <= min_x) {
-                            x = min_x;
-                            movingRight = true;
-                        }
-                    }
+                float distance = std::abs(playerX - x);
+                if (!movingRight && distance < 100 && !isAttacking) {
+                    isAttacking = true;
+                    currentFrame = 0;
+                    isIdle = false;
+                }
+
+                if (isAttacking) {
                     frameTimer++;
                     if (frameTimer >= frameDelay) {
                         frameTimer = 0;
-                        currentFrame = (currentFrame + 1) % moveFrameCount;
+                        currentFrame++;
+                        if (currentFrame >= attackFrameCount) {
+                            isAttacking = false;
+                            currentFrame = 0;
+                            isIdle = true;
+                        }
                     }
+                } else {
+                    if (isIdle) patrols[i] = true;
                 }
             }
+
+            if (attackCooldown > 0) attackCooldown--;
         }
+        patrolStep(patrolArrays(columns), begin, end, frameDelay, moveFrameCount);
+    }
 
-        if (attackCooldown > 0) attackCooldown--;
+    static SDL_Rect attackRect(const EntityColumns<NewEnemy>& columns, size_t i) {
+        SDL_Rect attackRect = { static_cast<int>(columns.x[i]), static_cast<int>(columns.y[i]), 40, 40 };
+        if (columns.movingRight[i]) {
+            attackRect.x += 15;
+        } else {
+            attackRect.x -= 60;
+        }
+        return attackRect;
+    }
+
+    static void publishBoxes(const EntityColumns<NewEnemy>& columns, CombatWorld& combat, float cameraX) {
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns.isDying[i] || columns.isHurt[i]) continue;
+            SDL_Rect body = { combatX(columns.x[i], cameraX), static_cast<int>(columns.y[i]), 64, 64 };
+            combat.addHurtbox(body, FACTION_ENEMY, OWNER_NEW_ENEMY, i);
+            if (columns.isAttacking[i] && columns.attackCooldown[i] <= 0) {
+                combat.addHitbox(attackRect(columns, i), FACTION_ENEMY, attackDamage, OWNER_NEW_ENEMY, i);
+            }
+        }
     }
 
-    void render(SDL_Renderer* renderer, float cameraX) {
-        SDL_Rect dstRect = { static_cast<int>(x - cameraX), static_cast<int>(y), 110, 110 };
+    static void takeHit(EntityColumns<NewEnemy>& columns, size_t i) {
+        columns.isHurt[i] = true;
+        columns.currentFrame[i] = 0;
+        columns.hitCount[i]++;
+        if (columns.hitCount[i] >= hitsToDie) {
+            columns.isHurt[i] = false;
+            columns.isDying[i] = true;
+            columns.currentFrame[i] = 0;
+        }
+    }
+
+    static void render(const EntityColumns<NewEnemy>& columns, size_t i, SDL_Renderer* renderer, float cameraX) {
+        SDL_Rect dstRect = { static_cast<int>(columns.x[i] - cameraX), static_cast<int>(columns.y[i]), 110, 110 };
         if (dstRect.x + dstRect.w > 0 && dstRect.x < SCREEN_WIDTH) {
-            SDL_Texture* currentTexture;
+            const NewEnemy& newEnemy = columns.cold[i];
+            bool isAttacking = columns.isAttacking[i];
+            bool movingRight = columns.movingRight[i];
+            TextureHandle currentTexture;
             int frameWidth, frameHeight;
 
-            if (isDying) {
-                currentTexture = dyingTexture;
+            if (columns.isDying[i]) {
+                currentTexture = newEnemy.dyingTexture;
                 frameWidth = 90;
                 frameHeight = 64;
-            } else if (isHurt) {
-                currentTexture = hurtTexture;
+            } else if (columns.isHurt[i]) {
+                currentTexture = newEnemy.hurtTexture;
                 frameWidth = 90;
                 frameHeight = 64;
             } else if (isAttacking) {
-                currentTexture = attackTexture;
+                currentTexture = newEnemy.attackTexture;
                 frameWidth = 90;
                 frameHeight = 64;
             } else {
-                currentTexture = isIdle ? moveTexture : idleTexture;
+                currentTexture = columns.isIdle[i] ? newEnemy.moveTexture : newEnemy.idleTexture;
                 frameWidth = 90;
                 frameHeight = 64;
             }
 
-            SDL_Rect srcRect = { currentFrame * frameWidth, 0, frameWidth, frameHeight };
+            SDL_Rect srcRect = { columns.currentFrame[i] * frameWidth, 0, frameWidth, frameHeight };
             SDL_RendererFlip flip = (isAttacking && !movingRight) ? SDL_FLIP_HORIZONTAL : (movingRight ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE);
-            if (currentTexture) SDL_RenderCopyEx(renderer, currentTexture, &srcRect, &dstRect, 0, NULL, flip);
+            if (currentTexture.get()) renderCopy(renderer, currentTexture, &srcRect, &dstRect, flip);
         }
     }
 
-    void cleanup() {
-        if (moveTexture) SDL_DestroyTexture(moveTexture);
-        if (attackTexture) SDL_DestroyTexture(attackTexture);
-        if (dyingTexture) SDL_DestroyTexture(dyingTexture);
-        if (hurtTexture) SDL_DestroyTexture(hurtTexture);
-        if (idleTexture) SDL_DestroyTexture(idleTexture);
+    void cleanup(TextureManager& textureManager) {
+        textureManager.release(moveTexture);
+        textureManager.release(attackTexture);
+        textureManager.release(dyingTexture);
+        textureManager.release(hurtTexture);
+        textureManager.release(idleTexture);
     }
 };
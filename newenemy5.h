@@ -1,80 +1,75 @@
+// Nhân vật cuối level: chạm vào thì hiện màn hình chiến thắng. Phần cold của EntityColumns<NewEnemy5>.
 struct NewEnemy5 {
-    float x, y;
-    float min_x, max_x;
-    SDL_Texture* idleTexture;
-    SDL_Texture* moveTexture;
-    int currentFrame;
-    int idleFrameCount;
-    int moveFrameCount;
-    int frameDelay;
-    int frameTimer;
-    bool isMoving;
-    bool toRemove;
+    static constexpr int idleFrameCount = 10;
+    static constexpr int moveFrameCount = 6;
+    static constexpr int frameDelay = 8;
+
+    TextureHandle idleTexture;
+    TextureHandle moveTexture;
     bool isHit;
     bool isEndScreen;
-    SDL_Texture* endScreenTexture;
+    TextureHandle endScreenTexture;
     SDL_Texture* endTextTexture;
-    SDL_Texture* playerIdleTexture;
+    TextureHandle playerIdleTexture;
     SDL_Texture* helloTextTexture;
     SDL_Rect endTextRect;
     SDL_Rect playerRect;
     SDL_Rect helloTextRect;
 
-    void init(SDL_Renderer* renderer, float start_x, float start_y, float min_x, float max_x) {
-        x = start_x;
-        y = start_y;
-        this->min_x = min_x;
-        this->max_x = max_x;
-
-        std::string idlePath = "assets/newenemy5_idle_sheet.png";
-        SDL_Surface* idleSurface = IMG_Load(idlePath.c_str());
-        idleTexture = idleSurface ? SDL_CreateTextureFromSurface(renderer, idleSurface) : nullptr;
-        if (!idleSurface) std::cerr << "❌ Không tải được " << idlePath << ": " << IMG_GetError() << std::endl;
-        if (idleSurface) SDL_FreeSurface(idleSurface);
-
-        std::string movePath = "assets/newenemy5_move_sheet.png";
-        SDL_Surface* moveSurface = IMG_Load(movePath.c_str());
-        moveTexture = moveSurface ? SDL_CreateTextureFromSurface(renderer, moveSurface) : nullptr;
-        if (!moveSurface) std::cerr << "❌ Không tải được " << movePath << ": " << IMG_GetError() << std::endl;
-        if (moveSurface) SDL_FreeSurface(moveSurface);
-
-        endScreenTexture = IMG_LoadTexture(renderer, "assets/menu.png");
-        if (!endScreenTexture) std::cerr << "❌ Không tải được menu.png: " << IMG_GetError() << std::endl;
-
-        playerIdleTexture = IMG_LoadTexture(renderer, "assets/Idle-Sheet1.png");
-        if (!playerIdleTexture) std::cerr << "❌ Không tải được Idle-Sheet1.png: " << IMG_GetError() << std::endl;
-
-        TTF_Font* endFont = TTF_OpenFont("assets/Legacy.ttf", 30);
-        if (!endFont) std::cerr << "❌ Không tải được Legacy.ttf: " << TTF_GetError() << std::endl;
-
-        SDL_Color yellow = {255, 255, 0, 255};
-        SDL_Surface* endSurface = TTF_RenderUTF8_Blended(endFont, "YOU WIN", yellow);
-        endTextTexture = endSurface ? SDL_CreateTextureFromSurface(renderer, endSurface) : nullptr;
-        endTextRect = endSurface ? SDL_Rect{(SCREEN_WIDTH - endSurface->w) / 2, 0, endSurface->w, endSurface->h} : SDL_Rect{0, 0, 0, 0};
-        if (endSurface) SDL_FreeSurface(endSurface);
+    static void listAssets(std::vector<std::string>& paths) {
+        paths.push_back(ASSETS_PATH + "newenemy5_idle_sheet.png");
+        paths.push_back(ASSETS_PATH + "newenemy5_move_sheet.png");
+        paths.push_back(ASSETS_PATH + "menu.png");
+        paths.push_back(ASSETS_PATH + "Idle-Sheet1.png");
+    }
 
-        SDL_Surface* helloSurface = TTF_RenderUTF8_Blended(endFont, "CONGRUTULATIONS!", yellow);
-        helloTextTexture = helloSurface ? SDL_CreateTextureFromSurface(renderer, helloSurface) : nullptr;
-        helloTextRect = helloSurface ? SDL_Rect{0, 0, helloSurface->w, helloSurface->h} : SDL_Rect{0, 0, 0, 0};
-        if (helloSurface) SDL_FreeSurface(helloSurface);
+    static size_t spawn(EntityColumns<NewEnemy5>& columns, SDL_Renderer* renderer, float start_x, float start_y, float min_x, float max_x, TextureManager& textureManager) {
+        size_t i = columns.add(start_x, start_y, min_x, max_x, 0.0f);
+        columns.cold[i].init(renderer, textureManager);
+        return i;
+    }
 
-        if (endFont) TTF_CloseFont(endFont);
+    void init(SDL_Renderer* renderer, TextureManager& textureManager) {
+        idleTexture = textureManager.acquire(ASSETS_PATH + "newenemy5_idle_sheet.png");
+        moveTexture = textureManager.acquire(ASSETS_PATH + "newenemy5_move_sheet.png");
+        endScreenTexture = textureManager.acquire(ASSETS_PATH + "menu.png");
+        playerIdleTexture = textureManager.acquire(ASSETS_PATH + "Idle-Sheet1.png");
+
+        endTextTexture = nullptr;
+        helloTextTexture = nullptr;
+        endTextRect = { 0, 0, 0, 0 };
+        helloTextRect = { 0, 0, 0, 0 };
+        if (renderer) {
+            TTF_Font* endFont = TTF_OpenFontRW(openAsset(ASSETS_PATH + "Legacy.ttf"), 1, 30);
+            if (!endFont) std::cerr << "❌ Không tải được Legacy.ttf: " << TTF_GetError() << std::endl;
+
+            SDL_Color yellow = {255, 255, 0, 255};
+            SDL_Surface* endSurface = TTF_RenderUTF8_Blended(endFont, "YOU WIN", yellow);
+            endTextTexture = endSurface ? SDL_CreateTextureFromSurface(renderer, endSurface) : nullptr;
+            endTextRect = endSurface ? SDL_Rect{(SCREEN_WIDTH - endSurface->w) / 2, 0, endSurface->w, endSurface->h} : SDL_Rect{0, 0, 0, 0};
+            if (endSurface) SDL_FreeSurface(endSurface);
+
+            SDL_Surface* helloSurface = TTF_RenderUTF8_Blended(endFont, "CONGRUTULATIONS!", yellow);
+            helloTextTexture = helloSurface ? SDL_CreateTextureFromSurface(renderer, helloSurface) : nullptr;
+            helloTextRect = helloSurface ? SDL_Rect{0, 0, helloSurface->w, helloSurface->h} : SDL_Rect{0, 0, 0, 0};
+            if (helloSurface) SDL_FreeSurface(helloSurface);
+
+            if (endFont) TTF_CloseFont(endFont);
+        }
 
         playerRect = { (SCREEN_WIDTH - 85) / 2, (SCREEN_HEIGHT - 85) / 2, 85, 85 };
 
-        currentFrame = 0;
-        idleFrameCount = 10;
-        moveFrameCount = 6;
-        frameDelay = 8;
-        frameTimer = 0;
-        isMoving = false;
-        toRemove = false;
         isHit = false;
         isEndScreen = false;
     }
 
-    void update() {
-        if (isHit || isEndScreen) {
+    static void update(EntityColumns<NewEnemy5>& columns, size_t i) {
+        const NewEnemy5& newEnemy5 = columns.cold[i];
+        int& currentFrame = columns.currentFrame[i];
+        int& frameTimer = columns.frameTimer[i];
+        uint8_t& isMoving = columns.isMoving[i];
+
+        if (newEnemy5.isHit || newEnemy5.isEndScreen) {
             frameTimer++;
             if (frameTimer >= frameDelay) {
                 frameTimer = 0;
@@ -91,33 +86,27 @@ struct NewEnemy5 {
             } else {
                 currentFrame = (currentFrame + 1) % idleFrameCount;
             }
-            if (currentFrame == 0 && rand() % 10 < 3) {
+            if (currentFrame == 0 && nextRandom() % 10 < 3) {
                 isMoving = !isMoving;
             }
         }
     }
 
-    void render(SDL_Renderer* renderer, float cameraX) {
-        if (isEndScreen) {
-            SDL_RenderCopy(renderer, endScreenTexture, NULL, NULL);
-            SDL_Rect srcRect = { (currentFrame % 4) * 64, 0, 64, 64 };
-            SDL_RenderCopyEx(renderer, playerIdleTexture, &srcRect, &playerRect, 0, NULL, SDL_FLIP_NONE);
-            if (helloTextTexture) {
-                helloTextRect.x = playerRect.x + (playerRect.w - helloTextRect.w) / 2;
-                helloTextRect.y = playerRect.y - helloTextRect.h - 10;
-                SDL_RenderCopy(renderer, helloTextTexture, NULL, &helloTextRect);
-            }
-            endTextRect.y = playerRect.y + playerRect.h + 10;
-            if (endTextTexture) SDL_RenderCopy(renderer, endTextTexture, NULL, &endTextRect);
-        } else if (!isHit) {
-            SDL_Rect dstRect = { static_cast<int>(x - cameraX), static_cast<int>(y), 64, 64 };
+    static void render(EntityColumns<NewEnemy5>& columns, size_t i, SDL_Renderer* renderer, float cameraX) {
+        NewEnemy5& newEnemy5 = columns.cold[i];
+        int currentFrame = columns.currentFrame[i];
+        if (newEnemy5.isEndScreen) {
+            newEnemy5.renderEndScreen(renderer, currentFrame);
+        } else if (!newEnemy5.isHit) {
+            SDL_Rect dstRect = { static_cast<int>(columns.x[i] - cameraX), static_cast<int>(columns.y[i]), 64, 64 };
             if (dstRect.x + dstRect.w > 0 && dstRect.x < SCREEN_WIDTH) {
-                SDL_Texture* currentTexture = isMoving ? moveTexture : idleTexture;
+                bool isMoving = columns.isMoving[i];
+                const TextureHandle& currentTexture = isMoving ? newEnemy5.moveTexture : newEnemy5.idleTexture;
                 int frameWidth = isMoving ? 48 : 48;
                 int frameHeight = isMoving ? 33 : 35;
                 SDL_Rect srcRect = { currentFrame * frameWidth, 0, frameWidth, frameHeight };
-                if (currentTexture) {
-                    SDL_RenderCopy(renderer, currentTexture, &srcRect, &dstRect);
+                if (currentTexture.get()) {
+                    renderCopy(renderer, currentTexture, &srcRect, &dstRect);
                 } else {
                     SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
                     SDL_RenderFillRect(renderer, &dstRect);
@@ -126,18 +115,40 @@ struct NewEnemy5 {
         }
     }
 
-    void hit() {
-        isHit = true;
-        isEndScreen = true;
-        currentFrame = 0;
+    void renderEndScreen(SDL_Renderer* renderer, int currentFrame) {
+        renderCopy(renderer, endScreenTexture, NULL, NULL);
+        SDL_Rect srcRect = { (currentFrame % 4) * 64, 0, 64, 64 };
+        renderCopy(renderer, playerIdleTexture, &srcRect, &playerRect);
+        if (helloTextTexture) {
+            helloTextRect.x = playerRect.x + (playerRect.w - helloTextRect.w) / 2;
+            helloTextRect.y = playerRect.y - helloTextRect.h - 10;
+            SDL_RenderCopy(renderer, helloTextTexture, NULL, &helloTextRect);
+        }
+        endTextRect.y = playerRect.y + playerRect.h + 10;
+        if (endTextTexture) SDL_RenderCopy(renderer, endTextTexture, NULL, &endTextRect);
+    }
+
+    // Chỉ có hurtbox: chạm vào là thắng
+    static void publishBoxes(const EntityColumns<NewEnemy5>& columns, CombatWorld& combat, float cameraX) {
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (columns.cold[i].isHit) continue;
+            SDL_Rect body = { combatX(columns.x[i], cameraX), static_cast<int>(columns.y[i]), 64, 64 };
+            combat.addHurtbox(body, FACTION_ENEMY, OWNER_NEW_ENEMY5, i);
+        }
+    }
+
+    static void hit(EntityColumns<NewEnemy5>& columns, size_t i) {
+        columns.cold[i].isHit = true;
+        columns.cold[i].isEndScreen = true;
+        columns.currentFrame[i] = 0;
     }
 
-    void cleanup() {
-        if (idleTexture) SDL_DestroyTexture(idleTexture);
-        if (moveTexture) SDL_DestroyTexture(moveTexture);
-        if (endScreenTexture) SDL_DestroyTexture(endScreenTexture);
+    void cleanup(TextureManager& textureManager) {
+        textureManager.release(idleTexture);
+        textureManager.release(moveTexture);
+        textureManager.release(endScreenTexture);
         if (endTextTexture) SDL_DestroyTexture(endTextTexture);
-        if (playerIdleTexture) SDL_DestroyTexture(playerIdleTexture);
+        textureManager.release(playerIdleTexture);
         if (helloTextTexture) SDL_DestroyTexture(helloTextTexture);
     }
 };
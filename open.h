@@ -1,20 +1,358 @@
+const size_t TEXTURE_VRAM_BUDGET = 256 * 1024 * 1024;
+const long long TEXTURE_RELOAD_RETRY_FRAMES = 60;   // Tải lại thất bại thì chờ khoảng 1 giây mới thử lại
+
+struct TextureManager;
+
+struct TextureEntry {
+    std::string path;
+    SDL_Texture* texture;
+    int width;
+    int height;
+    int refCount;
+    size_t bytes;
+    SDL_Rect region;      // Vùng của sheet bên trong texture (toàn bộ texture nếu không nằm trong atlas)
+    TextureEntry* page;   // Trang atlas chứa sheet, nullptr nếu là texture riêng
+    TextureManager* manager;
+    long long lastUsedFrame;
+    bool evicted;         // Đã bị đẩy khỏi VRAM, sẽ được tải lại khi cần vẽ
+    long long retryFrame; // Frame sớm nhất được thử tải lại sau một lần thất bại
+};
+
+// Handle trỏ vào một entry trong cache; nhiều thực thể dùng chung cùng một texture
+struct TextureHandle {
+    TextureEntry* entry = nullptr;
+
+    SDL_Texture* get() const;
+};
+
 struct TextureManager {
-    SDL_Texture* map1Texture;
-    SDL_Texture* map2Texture;
-    SDL_Texture* doorTexture;
+    SDL_Renderer* renderer;
+    std::unordered_map<std::string, TextureEntry> entries;
+    Atlas atlas;
+    bool useAtlas;
+    int hits;
+    int misses;
+    size_t bytesLoaded;
+    size_t bytesSaved;
+    size_t budget;        // 0 = không giới hạn
+    size_t residentBytes;
+    size_t peakResidentBytes;
+    long long frame;
+    int evictions;
+    int reloads;
+    int failedReloads;
+
+    TextureHandle map1Texture;
+    TextureHandle map2Texture;
+    TextureHandle doorTexture;
+
+    void init(SDL_Renderer* renderer, size_t budget = TEXTURE_VRAM_BUDGET) {
+        this->renderer = renderer;
+        hits = 0;
+        misses = 0;
+        bytesLoaded = 0;
+        bytesSaved = 0;
+        this->budget = budget;
+        residentBytes = 0;
+        peakResidentBytes = 0;
+        frame = 0;
+        evictions = 0;
+        reloads = 0;
+        failedReloads = 0;
+        useAtlas = atlas.load(ASSETS_PATH + "atlas.txt");
+        if (useAtlas) {
+            std::cout << "Atlas: " << atlas.frames.size() << " sheets in " << atlas.pageFiles.size() << " page(s)" << std::endl;
+        }
+        map1Texture = acquire(ASSETS_PATH + "map1.png");
+        map2Texture = acquire(ASSETS_PATH + "map2.png");
+        doorTexture = acquire(ASSETS_PATH + "door.png");
+    }
+
+    // Mỗi file chỉ được giải mã và upload lên GPU một lần cho cả tiến trình
+    TextureHandle acquire(const std::string& path) {
+        auto it = entries.find(path);
+        if (it != entries.end()) {
+            hits++;
+            bytesSaved += it->second.bytes;
+            it->second.refCount++;
+            return TextureHandle{ &it->second };
+        }
+
+        misses++;
+        TextureEntry& entry = newEntry(path);
+        entry.refCount = 1;
+
+        const AtlasFrame* frame = findFrame(path);
+        if (frame) {
+            // Trang đã có trong cache thì chỉ tăng refCount, không tính vào thống kê hit
+            std::string pagePath = ASSETS_PATH + atlas.pageFiles[frame->page];
+            auto pageIt = entries.find(pagePath);
+            TextureHandle page;
+            if (pageIt != entries.end()) {
+                pageIt->second.refCount++;
+                page.entry = &pageIt->second;
+            } else {
+                page = acquire(pagePath);
+            }
+            entry.page = page.entry;
+            entry.width = frame->rect.w;
+            entry.height = frame->rect.h;
+            entry.region = frame->rect;
+            entry.bytes = static_cast<size_t>(frame->rect.w) * frame->rect.h * 4;
+            return TextureHandle{ &entry };
+        }
+
+        load(entry);
+        return TextureHandle{ &entry };
+    }
+
+    TextureEntry& newEntry(const std::string& path) {
+        TextureEntry& entry = entries[path];
+        entry.path = path;
+        entry.texture = nullptr;
+        entry.width = 0;
+        entry.height = 0;
+        entry.refCount = 0;
+        entry.bytes = 0;
+        entry.region = { 0, 0, 0, 0 };
+        entry.page = nullptr;
+        entry.manager = this;
+        entry.lastUsedFrame = frame;
+        entry.evicted = false;
+        entry.retryFrame = 0;
+        return entry;
+    }
+
+    bool load(TextureEntry& entry) {
+        if (!renderer) return true;   // Headless: chỉ giữ entry trong cache, không giải mã ảnh
+        if (loadFromBundle(entry)) return true;
+        SDL_Surface* surface = IMG_Load(entry.path.c_str());
+        if (!surface) {
+            std::cerr << "❌ Không tải được " << entry.path << ": " << IMG_GetError() << std::endl;
+            return false;
+        }
+        uploadSurface(entry, surface);
+        return true;
+    }
+
+    // Pixel trong bundle đã ở đúng định dạng nên tạo texture thẳng từ vùng nhớ đã mmap
+    bool loadFromBundle(TextureEntry& entry) {
+        const BundleEntry* packed = assetBundle.findPath(entry.path);
+        if (!packed || packed->kind != BUNDLE_KIND_PIXELS) return false;
+        SDL_Texture* texture = SDL_CreateTexture(renderer, assetBundle.header->pixelFormat, SDL_TEXTUREACCESS_STATIC,
+                                                 packed->width, packed->height);
+        if (!texture) return false;
+        SDL_UpdateTexture(texture, NULL, assetBundle.data(*packed), packed->pitch);
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        entry.texture = texture;
+        entry.width = packed->width;
+        entry.height = packed->height;
+        entry.bytes = static_cast<size_t>(packed->width) * packed->height * 4;
+        entry.region = { 0, 0, packed->width, packed->height };
+        bytesLoaded += entry.bytes;
+        addResident(entry);
+        return true;
+    }
+
+    const AtlasFrame* findFrame(const std::string& path) const {
+        if (!useAtlas || path.compare(0, ASSETS_PATH.size(), ASSETS_PATH) != 0) return nullptr;
+        return atlas.find(path.substr(ASSETS_PATH.size()));
+    }
+
+    // File ảnh thực sự cần giải mã cho một sheet (trang atlas nếu sheet nằm trong atlas)
+    std::string sourceFile(const std::string& path) const {
+        const AtlasFrame* frame = findFrame(path);
+        return frame ? ASSETS_PATH + atlas.pageFiles[frame->page] : path;
+    }
+
+    // Texture đã bị đẩy khỏi VRAM được coi như chưa tải để AssetLoader có thể giải mã lại trước
+    bool isLoaded(const std::string& path) const {
+        auto it = entries.find(path);
+        return it != entries.end() && !it->second.evicted;
+    }
+
+    void uploadSurface(TextureEntry& entry, SDL_Surface* surface) {
+        entry.texture = SDL_CreateTextureFromSurface(renderer, surface);
+        entry.width = surface->w;
+        entry.height = surface->h;
+        entry.bytes = static_cast<size_t>(surface->w) * surface->h * 4;
+        entry.region = { 0, 0, surface->w, surface->h };
+        bytesLoaded += entry.bytes;
+        addResident(entry);
+        SDL_FreeSurface(surface);
+    }
 
-    void init(SDL_Renderer* renderer) {
-        map1Texture = IMG_LoadTexture(renderer, (ASSETS_PATH + "map1.png").c_str());
-        if (!map1Texture) std::cerr << "❌ Không tải được map1.png: " << IMG_GetError() << std::endl;
-        map2Texture = IMG_LoadTexture(renderer, (ASSETS_PATH + "map2.png").c_str());
-        if (!map2Texture) std::cerr << "❌ Không tải được map2.png: " << IMG_GetError() << std::endl;
-        doorTexture = IMG_LoadTexture(renderer, (ASSETS_PATH + "door.png").c_str());
-        if (!doorTexture) std::cerr << "❌ Không tải được door.png: " << IMG_GetError() << std::endl;
+    void addResident(TextureEntry& entry) {
+        entry.lastUsedFrame = frame;
+        if (entry.evicted) {
+            entry.evicted = false;
+            reloads++;
+        }
+        residentBytes += entry.bytes;
+        if (residentBytes > peakResidentBytes) peakResidentBytes = residentBytes;
+    }
+
+    // Trả về texture đang nằm trên GPU của entry (trang atlas nếu là sheet), tải lại nếu đã bị đẩy ra.
+    // Tải lại thất bại thì entry vẫn ở trạng thái evicted và được thử lại sau TEXTURE_RELOAD_RETRY_FRAMES.
+    SDL_Texture* resident(TextureEntry& entry) {
+        TextureEntry& owner = entry.page ? *entry.page : entry;
+        owner.lastUsedFrame = frame;
+        if (owner.evicted && frame >= owner.retryFrame && !load(owner)) {
+            owner.retryFrame = frame + TEXTURE_RELOAD_RETRY_FRAMES;
+            failedReloads++;
+        }
+        return owner.texture;
+    }
+
+    void evict(TextureEntry& entry) {
+        SDL_DestroyTexture(entry.texture);
+        entry.texture = nullptr;
+        entry.evicted = true;
+        residentBytes -= entry.bytes;
+        evictions++;
+    }
+
+    // Gọi sau SDL_RenderPresent: khi vượt ngân sách, đẩy các texture lâu không được vẽ nhất ra khỏi VRAM.
+    // Texture đã vẽ trong frame này không bao giờ bị đẩy ra, kể cả khi vẫn vượt ngân sách.
+    void endFrame() {
+        if (budget > 0 && residentBytes > budget) {
+            std::vector<TextureEntry*> candidates;
+            for (auto& pair : entries) {
+                TextureEntry& entry = pair.second;
+                if (entry.texture && !entry.page && entry.lastUsedFrame < frame) candidates.push_back(&entry);
+            }
+            std::sort(candidates.begin(), candidates.end(), [](const TextureEntry* a, const TextureEntry* b) {
+                return a->lastUsedFrame < b->lastUsedFrame;
+            });
+            for (TextureEntry* entry : candidates) {
+                if (residentBytes <= budget) break;
+                evict(*entry);
+            }
+        }
+        frame++;
+    }
+
+    // Nhận surface đã được giải mã ở luồng khác; chỉ upload nếu file chưa có trong cache
+    void adopt(const std::string& path, SDL_Surface* surface) {
+        auto it = entries.find(path);
+        if (it != entries.end() && !it->second.evicted) {
+            SDL_FreeSurface(surface);
+            return;
+        }
+        if (it == entries.end()) misses++;
+        TextureEntry& entry = it != entries.end() ? it->second : newEntry(path);
+        uploadSurface(entry, surface);
+    }
+
+    // Texture vẫn nằm trong cache khi refCount về 0 để level sau dùng lại
+    void release(TextureHandle& handle) {
+        if (handle.entry && handle.entry->refCount > 0) handle.entry->refCount--;
+        handle.entry = nullptr;
+    }
+
+    void printStats() const {
+        int referenced = 0;
+        for (const auto& pair : entries) {
+            if (pair.second.refCount > 0) referenced++;
+        }
+        std::cout << "TextureManager: " << entries.size() << " textures (" << referenced << " in use), "
+                  << "hits=" << hits << ", misses=" << misses << ", "
+                  << "loaded=" << bytesLoaded / 1024 << " KB, saved=" << bytesSaved / 1024 << " KB" << std::endl;
+        std::cout << "Residency: " << residentBytes / 1024 << " KB resident (peak " << peakResidentBytes / 1024 << " KB), budget=";
+        if (budget > 0) std::cout << budget / 1024 << " KB";
+        else std::cout << "unlimited";
+        std::cout << ", evictions=" << evictions << ", reloads=" << reloads << ", failedReloads=" << failedReloads << std::endl;
     }
 
     void cleanup() {
-        if (map1Texture) SDL_DestroyTexture(map1Texture);
-        if (map2Texture) SDL_DestroyTexture(map2Texture);
-        if (doorTexture) SDL_DestroyTexture(doorTexture);
+        for (auto& pair : entries) {
+            if (pair.second.texture && !pair.second.page) SDL_DestroyTexture(pair.second.texture);
+        }
+        entries.clear();
+        residentBytes = 0;
     }
 };
+
+SDL_Texture* TextureHandle::get() const {
+    return entry ? entry->manager->resident(*entry) : nullptr;
+}
+
+struct RenderStats {
+    SDL_Texture* lastTexture;
+    long long copies;
+    long long textureSwitches;
+    long long frames;
+};
+
+RenderStats renderStats = {};
+
+// Vẽ một sheet trong cache; srcRect tính theo toạ độ của sheet và được dời vào vùng atlas
+void renderCopy(SDL_Renderer* renderer, const TextureHandle& handle, const SDL_Rect* srcRect,
+                const SDL_Rect* dstRect, SDL_RendererFlip flip = SDL_FLIP_NONE) {
+    TextureEntry* entry = handle.entry;
+    SDL_Texture* texture = handle.get();
+    if (!texture) return;
+
+    SDL_Rect bounds = { 0, 0, entry->region.w, entry->region.h };
+    SDL_Rect src = bounds;
+    if (srcRect && !SDL_IntersectRect(srcRect, &bounds, &src)) return;
+    src.x += entry->region.x;
+    src.y += entry->region.y;
+
+    if (texture != renderStats.lastTexture) {
+        renderStats.textureSwitches++;
+        renderStats.lastTexture = texture;
+    }
+    renderStats.copies++;
+    if (flip == SDL_FLIP_NONE) {
+        SDL_RenderCopy(renderer, texture, &src, dstRect);
+    } else {
+        SDL_RenderCopyEx(renderer, texture, &src, dstRect, 0, NULL, flip);
+    }
+}
+
+// Lặp một sheet theo chiều ngang trên dstRect (mỗi ô rộng tileWidth) bằng một lệnh SDL_RenderGeometry;
+// chỉ các ô nằm trong màn hình được đưa vào
+void renderTiled(SDL_Renderer* renderer, const TextureHandle& handle, const SDL_Rect& dstRect, int tileWidth) {
+    static std::vector<SDL_Vertex> vertices;
+    static std::vector<int> indices;
+    TextureEntry* entry = handle.entry;
+    SDL_Texture* texture = handle.get();
+    if (!texture) return;
+
+    const TextureEntry& owner = entry->page ? *entry->page : *entry;
+    float u0 = static_cast<float>(entry->region.x) / owner.width;
+    float v0 = static_cast<float>(entry->region.y) / owner.height;
+    float u1 = static_cast<float>(entry->region.x + entry->region.w) / owner.width;
+    float v1 = static_cast<float>(entry->region.y + entry->region.h) / owner.height;
+
+    int columns = dstRect.w / tileWidth;
+    int first = std::max(0, -dstRect.x / tileWidth);
+    int last = std::min(columns - 1, (SCREEN_WIDTH - 1 - dstRect.x) / tileWidth);
+    if (first > last) return;
+
+    vertices.clear();
+    indices.clear();
+    SDL_Color white = { 255, 255, 255, 255 };
+    float top = static_cast<float>(dstRect.y);
+    float bottom = static_cast<float>(dstRect.y + dstRect.h);
+    for (int i = first; i <= last; i++) {
+        float left = static_cast<float>(dstRect.x + i * tileWidth);
+        float right = left + tileWidth;
+        int base = static_cast<int>(vertices.size());
+        vertices.push_back({ { left, top }, white, { u0, v0 } });
+        vertices.push_back({ { right, top }, white, { u1, v0 } });
+        vertices.push_back({ { right, bottom }, white, { u1, v1 } });
+        vertices.push_back({ { left, bottom }, white, { u0, v1 } });
+        int quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+        indices.insert(indices.end(), quad, quad + 6);
+    }
+
+    if (texture != renderStats.lastTexture) {
+        renderStats.textureSwitches++;
+        renderStats.lastTexture = texture;
+    }
+    renderStats.copies++;
+    SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+}
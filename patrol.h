@@ -0,0 +1,223 @@
+// Bước tuần tra gộp cho nhiều hàng một lúc: x += speed (hoặc -=), kẹp vào [minX, maxX] và đổi hướng,
+// rồi frameTimer++ và quay vòng currentFrame. Vòng state machine của từng loại đánh dấu hàng nào đang
+// tuần tra vào cột patrol, kernel làm phần còn lại trên mảng liền nhau. Bản SSE2/AVX2 cho kết quả
+// trùng từng bit với bản vô hướng: chỉ có cộng/trừ float một lần và so sánh, không gộp phép tính.
+#if defined(__SSE2__) || defined(_M_X64)
+#define PATROL_SSE2 1
+#endif
+#if defined(PATROL_SSE2) && defined(__GNUC__) && defined(__x86_64__)
+#define PATROL_AVX2 1
+#endif
+
+enum PatrolKernel {
+    PATROL_SCALAR,
+    PATROL_KERNEL_SSE2,
+    PATROL_KERNEL_AVX2
+};
+
+const char* const PATROL_KERNEL_NAMES[] = { "scalar", "sse2", "avx2" };
+
+struct PatrolArrays {
+    float* x;
+    const float* speed;
+    const float* minX;
+    const float* maxX;
+    uint8_t* movingRight;
+    int* frameTimer;
+    int* currentFrame;
+    const uint8_t* patrol;
+};
+
+template <typename Cold>
+PatrolArrays patrolArrays(EntityColumns<Cold>& columns) {
+    return { columns.x.data(), columns.speed.data(), columns.minX.data(), columns.maxX.data(),
+             columns.movingRight.data(), columns.frameTimer.data(), columns.currentFrame.data(), columns.patrol.data() };
+}
+
+void patrolStepScalar(const PatrolArrays& a, size_t begin, size_t end, int frameDelay, int frameCount) {
+    for (size_t i = begin; i < end; i++) {
+        if (!a.patrol[i]) continue;
+        float& x = a.x[i];
+        if (a.movingRight[i]) {
+            x += a.speed[i];
+            if (x >= a.maxX[i]) {
+                x = a.maxX[i];
+                a.movingRight[i] = false;
+            }
+        } else {
+            x -= a.speed[i];
+            if (x <= a.minX[i]) {
+                x = a.minX[i];
+                a.movingRight[i] = true;
+            }
+        }
+        a.frameTimer[i]++;
+        if (a.frameTimer[i] >= frameDelay) {
+            a.frameTimer[i] = 0;
+            a.currentFrame[i] = (a.currentFrame[i] + 1) % frameCount;
+        }
+    }
+}
+
+#ifdef PATROL_SSE2
+// (currentFrame + 1) % frameCount chỉ thay được bằng một lần trừ khi currentFrame + 1 nằm trong
+// (-frameCount, 2 * frameCount). Nhóm nào có làn ngoài khoảng đó thì cả nhóm đi đường vô hướng.
+void patrolStepSse2(const PatrolArrays& a, size_t begin, size_t end, int frameDelay, int frameCount) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i delayLimit = _mm_set1_epi32(frameDelay - 1);
+    const __m128i count = _mm_set1_epi32(frameCount);
+    const __m128i wrapLimit = _mm_set1_epi32(frameCount - 1);
+    const __m128i upperLimit = _mm_set1_epi32(2 * frameCount - 1);
+    const __m128i lowerLimit = _mm_set1_epi32(-frameCount + 1);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        uint32_t patrolBytes, rightBytes;
+        std::memcpy(&patrolBytes, a.patrol + i, 4);
+        if (patrolBytes == 0) continue;
+        std::memcpy(&rightBytes, a.movingRight + i, 4);
+        __m128i rightWide = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(rightBytes)), zero), zero);
+        __m128i activeWide = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(patrolBytes)), zero), zero);
+        __m128i active = _mm_xor_si128(_mm_cmpeq_epi32(activeWide, zero), _mm_set1_epi32(-1));
+        __m128i right = _mm_xor_si128(_mm_cmpeq_epi32(rightWide, zero), _mm_set1_epi32(-1));
+
+        __m128i timer = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.frameTimer + i)), one);
+        __m128i fire = _mm_and_si128(active, _mm_cmpgt_epi32(timer, delayLimit));
+        __m128i frame = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.currentFrame + i));
+        __m128i nextFrame = _mm_add_epi32(frame, one);
+        __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(nextFrame, upperLimit), _mm_cmplt_epi32(nextFrame, lowerLimit));
+        if (_mm_movemask_epi8(_mm_and_si128(fire, outside))) {
+            patrolStepScalar(a, i, i + 4, frameDelay, frameCount);
+            continue;
+        }
+        nextFrame = _mm_sub_epi32(nextFrame, _mm_and_si128(_mm_cmpgt_epi32(nextFrame, wrapLimit), count));
+        frame = _mm_or_si128(_mm_and_si128(fire, nextFrame), _mm_andnot_si128(fire, frame));
+        timer = _mm_andnot_si128(fire, timer);
+        __m128i oldTimer = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.frameTimer + i));
+        timer = _mm_or_si128(_mm_and_si128(active, timer), _mm_andnot_si128(active, oldTimer));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a.frameTimer + i), timer);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a.currentFrame + i), frame);
+
+        __m128 rightMask = _mm_castsi128_ps(right);
+        __m128 x = _mm_loadu_ps(a.x + i);
+        __m128 speed = _mm_loadu_ps(a.speed + i);
+        __m128 minX = _mm_loadu_ps(a.minX + i);
+        __m128 maxX = _mm_loadu_ps(a.maxX + i);
+        __m128 moved = _mm_or_ps(_mm_and_ps(rightMask, _mm_add_ps(x, speed)), _mm_andnot_ps(rightMask, _mm_sub_ps(x, speed)));
+        __m128 hitMax = _mm_and_ps(rightMask, _mm_cmpge_ps(moved, maxX));
+        __m128 hitMin = _mm_andnot_ps(rightMask, _mm_cmple_ps(moved, minX));
+        moved = _mm_or_ps(_mm_and_ps(hitMax, maxX), _mm_andnot_ps(hitMax, moved));
+        moved = _mm_or_ps(_mm_and_ps(hitMin, minX), _mm_andnot_ps(hitMin, moved));
+        __m128 activeMask = _mm_castsi128_ps(active);
+        _mm_storeu_ps(a.x + i, _mm_or_ps(_mm_and_ps(activeMask, moved), _mm_andnot_ps(activeMask, x)));
+
+        __m128i flipped = _mm_or_si128(_mm_castps_si128(hitMax), _mm_castps_si128(hitMin));
+        __m128i newRight = _mm_and_si128(_mm_xor_si128(right, flipped), one);
+        newRight = _mm_or_si128(_mm_and_si128(active, newRight), _mm_andnot_si128(active, rightWide));
+        uint32_t newRightBytes = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(newRight, zero), zero)));
+        std::memcpy(a.movingRight + i, &newRightBytes, 4);
+    }
+    patrolStepScalar(a, i, end, frameDelay, frameCount);
+}
+#endif
+
+#ifdef PATROL_AVX2
+// Như bản SSE2 nhưng 8 làn; chỉ gọi khi CPU báo có AVX2
+__attribute__((target("avx2")))
+void patrolStepAvx2(const PatrolArrays& a, size_t begin, size_t end, int frameDelay, int frameCount) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i allSet = _mm256_set1_epi32(-1);
+    const __m256i delayLimit = _mm256_set1_epi32(frameDelay - 1);
+    const __m256i count = _mm256_set1_epi32(frameCount);
+    const __m256i wrapLimit = _mm256_set1_epi32(frameCount - 1);
+    const __m256i upperLimit = _mm256_set1_epi32(2 * frameCount - 1);
+    const __m256i lowerLimit = _mm256_set1_epi32(-frameCount + 1);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        uint64_t patrolBytes, rightBytes;
+        std::memcpy(&patrolBytes, a.patrol + i, 8);
+        if (patrolBytes == 0) continue;
+        std::memcpy(&rightBytes, a.movingRight + i, 8);
+        __m256i rightWide = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(rightBytes)));
+        __m256i activeWide = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(patrolBytes)));
+        __m256i active = _mm256_xor_si256(_mm256_cmpeq_epi32(activeWide, _mm256_setzero_si256()), allSet);
+        __m256i right = _mm256_xor_si256(_mm256_cmpeq_epi32(rightWide, _mm256_setzero_si256()), allSet);
+
+        __m256i oldTimer = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.frameTimer + i));
+        __m256i timer = _mm256_add_epi32(oldTimer, one);
+        __m256i fire = _mm256_and_si256(active, _mm256_cmpgt_epi32(timer, delayLimit));
+        __m256i frame = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.currentFrame + i));
+        __m256i nextFrame = _mm256_add_epi32(frame, one);
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(nextFrame, upperLimit), _mm256_cmpgt_epi32(lowerLimit, nextFrame));
+        if (_mm256_movemask_epi8(_mm256_and_si256(fire, outside))) {
+            patrolStepScalar(a, i, i + 8, frameDelay, frameCount);
+            continue;
+        }
+        nextFrame = _mm256_sub_epi32(nextFrame, _mm256_and_si256(_mm256_cmpgt_epi32(nextFrame, wrapLimit), count));
+        frame = _mm256_blendv_epi8(frame, nextFrame, fire);
+        timer = _mm256_blendv_epi8(oldTimer, _mm256_andnot_si256(fire, timer), active);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a.frameTimer + i), timer);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a.currentFrame + i), frame);
+
+        __m256 rightMask = _mm256_castsi256_ps(right);
+        __m256 x = _mm256_loadu_ps(a.x + i);
+        __m256 speed = _mm256_loadu_ps(a.speed + i);
+        __m256 moved = _mm256_blendv_ps(_mm256_sub_ps(x, speed), _mm256_add_ps(x, speed), rightMask);
+        __m256 maxX = _mm256_loadu_ps(a.maxX + i);
+        __m256 minX = _mm256_loadu_ps(a.minX + i);
+        __m256 hitMax = _mm256_and_ps(rightMask, _mm256_cmp_ps(moved, maxX, _CMP_GE_OQ));
+        __m256 hitMin = _mm256_andnot_ps(rightMask, _mm256_cmp_ps(moved, minX, _CMP_LE_OQ));
+        moved = _mm256_blendv_ps(moved, maxX, hitMax);
+        moved = _mm256_blendv_ps(moved, minX, hitMin);
+        _mm256_storeu_ps(a.x + i, _mm256_blendv_ps(x, moved, _mm256_castsi256_ps(active)));
+
+        __m256i flipped = _mm256_or_si256(_mm256_castps_si256(hitMax), _mm256_castps_si256(hitMin));
+        __m256i newRight = _mm256_and_si256(_mm256_xor_si256(right, flipped), one);
+        newRight = _mm256_blendv_epi8(rightWide, newRight, active);
+        __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(newRight), _mm256_extracti128_si256(newRight, 1));
+        uint64_t newRightBytes = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_packus_epi16(packed, _mm_setzero_si128())));
+        std::memcpy(a.movingRight + i, &newRightBytes, 8);
+    }
+    patrolStepScalar(a, i, end, frameDelay, frameCount);
+}
+#endif
+
+PatrolKernel detectPatrolKernel() {
+#ifdef PATROL_AVX2
+    if (__builtin_cpu_supports("avx2")) return PATROL_KERNEL_AVX2;
+#endif
+#ifdef PATROL_SSE2
+    return PATROL_KERNEL_SSE2;
+#else
+    return PATROL_SCALAR;
+#endif
+}
+
+PatrolKernel patrolKernel = detectPatrolKernel();   // --simd=scalar|sse2|avx2 ép một bản cụ thể
+
+// Trả về false nếu bản đó không có trong bản build hoặc CPU không hỗ trợ
+bool selectPatrolKernel(const std::string& name) {
+    for (int kernel = PATROL_SCALAR; kernel <= PATROL_KERNEL_AVX2; kernel++) {
+        if (name != PATROL_KERNEL_NAMES[kernel]) continue;
+        if (kernel > detectPatrolKernel()) return false;
+        patrolKernel = static_cast<PatrolKernel>(kernel);
+        return true;
+    }
+    return false;
+}
+
+void patrolStep(const PatrolArrays& a, size_t begin, size_t end, int frameDelay, int frameCount) {
+#ifdef PATROL_AVX2
+    if (patrolKernel == PATROL_KERNEL_AVX2) {
+        patrolStepAvx2(a, begin, end, frameDelay, frameCount);
+        return;
+    }
+#endif
+#ifdef PATROL_SSE2
+    if (patrolKernel == PATROL_KERNEL_SSE2) {
+        patrolStepSse2(a, begin, end, frameDelay, frameCount);
+        return;
+    }
+#endif
+    patrolStepScalar(a, begin, end, frameDelay, frameCount);
+}
@@ -1,19 +1,20 @@
+// Một dải nền tảng: các ô cùng loại liền nhau trên một hàng, gộp thành một hình chữ nhật và một lệnh vẽ
 struct Platform {
     SDL_Rect rect;
-    SDL_Texture* texture;
+    TextureHandle texture;
 
-    void init(SDL_Renderer* renderer, int x, int y, int type, TextureManager& textureManager) {
-        rect = { x, y, TILE_WIDTH, TILE_HEIGHT };
+    void init(SDL_Renderer* renderer, int x, int y, int type, int columns, TextureManager& textureManager) {
+        rect = { x, y, columns * TILE_WIDTH, TILE_HEIGHT };
         texture = (type == 1) ? textureManager.map1Texture : textureManager.map2Texture;
-        if (!texture) std::cerr << "❌ Texture nền không hợp lệ cho loại " << type << std::endl;
+        if (renderer && !texture.get()) std::cerr << "❌ Texture nền không hợp lệ cho loại " << type << std::endl;
     }
 
     void render(SDL_Renderer* renderer, float cameraX) {
         SDL_Rect renderRect = rect;
         renderRect.x -= static_cast<int>(cameraX);
         if (renderRect.x + renderRect.w > 0 && renderRect.x < SCREEN_WIDTH) {
-            if (texture) {
-                SDL_RenderCopy(renderer, texture, NULL, &renderRect);
+            if (texture.get()) {
+                renderTiled(renderer, texture, renderRect, TILE_WIDTH);
             } else {
                 SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
                 SDL_RenderFillRect(renderer, &renderRect);
@@ -1,5 +1,6 @@
 struct Player {
     float x, y;
+    float previousX, previousY;   // Vị trí ở tick trước, để nội suy khi vẽ
     float velocityY;
     bool isJumping;
     bool isIdle;
@@ -14,15 +15,15 @@ struct Player {
     bool deathAnimationComplete;
     int attackFrameCounter;
     SDL_Rect rect;
-    SDL_Texture* idleTexture;
-    SDL_Texture* runTexture;
-    SDL_Texture* attackTexture;
-    SDL_Texture* jumpStartTexture;
-    SDL_Texture* jumpMidTexture;
-    SDL_Texture* jumpEndTexture;
-    SDL_Texture* deadTexture;
-    SDL_Texture* healthBarTexture;
-    SDL_Texture* healthBarEmptyTexture;
+    TextureHandle idleTexture;
+    TextureHandle runTexture;
+    TextureHandle attackTexture;
+    TextureHandle jumpStartTexture;
+    TextureHandle jumpMidTexture;
+    TextureHandle jumpEndTexture;
+    TextureHandle deadTexture;
+    TextureHandle healthBarTexture;
+    TextureHandle healthBarEmptyTexture;
     int currentFrame;
     int frameCount;
     int deadFrameCount;
@@ -38,9 +39,23 @@ struct Player {
     int maxHealth;
     float displayHealth;
 
-    void init(SDL_Renderer* renderer, int startX, int startY) {
+    static void listAssets(std::vector<std::string>& paths) {
+        paths.push_back(ASSETS_PATH + "Idle-Sheet1.png");
+        paths.push_back(ASSETS_PATH + "RunRight-Sheet1.png");
+        paths.push_back(ASSETS_PATH + "Attack-Sheet1.png");
+        paths.push_back(ASSETS_PATH + "Jump-Start-Sheet.png");
+        paths.push_back(ASSETS_PATH + "Jump-Mid-Sheet.png");
+        paths.push_back(ASSETS_PATH + "Jump-End-Sheet.png");
+        paths.push_back(ASSETS_PATH + "Dead-Sheet.png");
+        paths.push_back(ASSETS_PATH + "health_bar_full.png");
+        paths.push_back(ASSETS_PATH + "health_bar_empty.png");
+    }
+
+    void init(SDL_Renderer* renderer, int startX, int startY, TextureManager& textureManager) {
         x = startX;
         y = startY;
+        previousX = x;
+        previousY = y;
         gameStartX = startX;
         gameStartY = startY;
         lastDeathX = startX;
@@ -64,46 +79,15 @@ struct Player {
         health = maxHealth;
         displayHealth = static_cast<float>(health);
 
-        SDL_Surface* idleSurface = IMG_Load((ASSETS_PATH + "Idle-Sheet1.png").c_str());
-        idleTexture = idleSurface ? SDL_CreateTextureFromSurface(renderer, idleSurface) : nullptr;
-        if (!idleSurface) std::cerr << "❌ Không tải được Idle-Sheet1.png: " << IMG_GetError() << std::endl;
-        if (idleSurface) SDL_FreeSurface(idleSurface);
-
-        SDL_Surface* runSurface = IMG_Load((ASSETS_PATH + "RunRight-Sheet1.png").c_str());
-        runTexture = runSurface ? SDL_CreateTextureFromSurface(renderer, runSurface) : nullptr;
-        if (!runSurface) std::cerr << "❌ Không tải được RunRight-Sheet1.png: " << IMG_GetError() << std::endl;
-        if (runSurface) SDL_FreeSurface(runSurface);
-
-        SDL_Surface* attackSurface = IMG_Load((ASSETS_PATH + "Attack-Sheet1.png").c_str());
-        attackTexture = attackSurface ? SDL_CreateTextureFromSurface(renderer, attackSurface) : nullptr;
-        if (!attackSurface) std::cerr << "❌ Không tải được Attack-Sheet1.png: " << IMG_GetError() << std::endl;
-        if (attackSurface) SDL_FreeSurface(attackSurface);
-
-        SDL_Surface* jumpStartSurface = IMG_Load((ASSETS_PATH + "Jump-Start-Sheet.png").c_str());
-        jumpStartTexture = jumpStartSurface ? SDL_CreateTextureFromSurface(renderer, jumpStartSurface) : nullptr;
-        if (!jumpStartSurface) std::cerr << "❌ Không tải được Jump-Start-Sheet.png: " << IMG_GetError() << std::endl;
-        if (jumpStartSurface) SDL_FreeSurface(jumpStartSurface);
-
-        SDL_Surface* jumpMidSurface = IMG_Load((ASSETS_PATH + "Jump-Mid-Sheet.png").c_str());
-        jumpMidTexture = jumpMidSurface ? SDL_CreateTextureFromSurface(renderer, jumpMidSurface) : nullptr;
-        if (!jumpMidSurface) std::cerr << "❌ Không tải được Jump-Mid-Sheet.png: " << IMG_GetError() << std::endl;
-        if (jumpMidSurface) SDL_FreeSurface(jumpMidSurface);
-
-        SDL_Surface* jumpEndSurface = IMG_Load((ASSETS_PATH + "Jump-End-Sheet.png").c_str());
-        jumpEndTexture = jumpEndSurface ? SDL_CreateTextureFromSurface(renderer, jumpEndSurface) : nullptr;
-        if (!jumpEndSurface) std::cerr << "❌ Không tải được Jump-End-Sheet.png: " << IMG_GetError() << std::endl;
-        if (jumpEndSurface) SDL_FreeSurface(jumpEndSurface);
-
-        SDL_Surface* deadSurface = IMG_Load((ASSETS_PATH + "Dead-Sheet.png").c_str());
-        deadTexture = deadSurface ? SDL_CreateTextureFromSurface(renderer, deadSurface) : nullptr;
-        if (!deadSurface) std::cerr << "❌ Không tải được Dead-Sheet.png: " << IMG_GetError() << std::endl;
-        if (deadSurface) SDL_FreeSurface(deadSurface);
-
-        healthBarTexture = IMG_LoadTexture(renderer, (ASSETS_PATH + "health_bar_full.png").c_str());
-        if (!healthBarTexture) std::cerr << "❌ Không tải được health_bar_full.png: " << IMG_GetError() << std::endl;
-
-        healthBarEmptyTexture = IMG_LoadTexture(renderer, (ASSETS_PATH + "health_bar_empty.png").c_str());
-        if (!healthBarEmptyTexture) std::cerr << "❌ Không tải được health_bar_empty.png: " << IMG_GetError() << std::endl;
+        idleTexture = textureManager.acquire(ASSETS_PATH + "Idle-Sheet1.png");
+        runTexture = textureManager.acquire(ASSETS_PATH + "RunRight-Sheet1.png");
+        attackTexture = textureManager.acquire(ASSETS_PATH + "Attack-Sheet1.png");
+        jumpStartTexture = textureManager.acquire(ASSETS_PATH + "Jump-Start-Sheet.png");
+        jumpMidTexture = textureManager.acquire(ASSETS_PATH + "Jump-Mid-Sheet.png");
+        jumpEndTexture = textureManager.acquire(ASSETS_PATH + "Jump-End-Sheet.png");
+        deadTexture = textureManager.acquire(ASSETS_PATH + "Dead-Sheet.png");
+        healthBarTexture = textureManager.acquire(ASSETS_PATH + "health_bar_full.png");
+        healthBarEmptyTexture = textureManager.acquire(ASSETS_PATH + "health_bar_empty.png");
 
         frameCount = 8;
         deadFrameCount = 8;
@@ -113,23 +97,14 @@ struct Player {
         deadFrameTimer = 0;
     }
 
-    void resetToNearestCheckpoint(const std::vector<Platform>& platforms) {
-        if (platforms.empty()) {
+    void resetToNearestCheckpoint(const CollisionGrid& grid) {
+        SDL_Rect nearestPlatform;
+        if (!grid.findNearestGround(lastDeathX, nearestPlatform)) {
             x = gameStartX;
             y = gameStartY;
         } else {
-            float minDistance = std::numeric_limits<float>::max();
-            Platform nearestPlatform = platforms[0];
-            for (const auto& platform : platforms) {
-                float platformCenterX = platform.rect.x + platform.rect.w / 2.0f;
-                float distance = std::abs(platformCenterX - lastDeathX);
-                if (distance < minDistance) {
-                    minDistance = distance;
-                    nearestPlatform = platform;
-                }
-            }
-            x = nearestPlatform.rect.x + (nearestPlatform.rect.w - rect.w) / 2.0f;
-            y = nearestPlatform.rect.y - rect.h;
+            x = nearestPlatform.x + (nearestPlatform.w - rect.w) / 2.0f;
+            y = nearestPlatform.y - rect.h;
         }
         rect.x = static_cast<int>(x);
         rect.y = static_cast<int>(y);
@@ -153,7 +128,8 @@ struct Player {
         std::cout << "Nhân vật hồi sinh tại x=" << x << ", y=" << y << ", health=" << health << std::endl;
     }
 
-    void update(const std::vector<Platform>& platforms) {
+    void update(const CollisionGrid& grid) {
+        PROFILE_SCOPE("Player::update");
         if (isDying) {
             deadFrameTimer++;
             if (deadFrameTimer >= deadFrameDelay) {
@@ -167,7 +143,7 @@ struct Player {
                     lastDeathY = y;
                     lives--;
                     if (lives > 0) {
-                        resetToNearestCheckpoint(platforms);
+                        resetToNearestCheckpoint(grid);
                     } else {
                         shouldQuit = true;
                     }
@@ -185,21 +161,19 @@ struct Player {
             newX = std::max(0.0f, x - 4);
         }
         if (isMovingRight) {
-            newX = std::min(static_cast<float>(MAP_WIDTH * TILE_WIDTH - rect.w), x + 4);
+            newX = std::min(static_cast<float>(levelWidthPixels - rect.w), x + 4);
         }
 
         SDL_Rect newRect = rect;
         newRect.x = static_cast<int>(newX);
         bool canMove = true;
-        for (const auto& platform : platforms) {
-            if (SDL_HasIntersection(&newRect, &platform.rect)) {
-                canMove = false;
-                if (isMovingLeft) {
-                    x = platform.rect.x + platform.rect.w;
-                } else if (isMovingRight) {
-                    x = platform.rect.x - rect.w;
-                }
-                break;
+        SDL_Rect platform;
+        if (grid.query(newRect, &platform, 1) > 0) {
+            canMove = false;
+            if (isMovingLeft) {
+                x = platform.x + platform.w;
+            } else if (isMovingRight) {
+                x = platform.x - rect.w;
             }
         }
         if (canMove) {
@@ -221,20 +195,15 @@ struct Player {
         }
 
         bool onPlatform = false;
-        for (const auto& platform : platforms) {
-            if (rect.x + rect.w > platform.rect.x && rect.x < platform.rect.x + platform.rect.w &&
-                y + rect.h >= platform.rect.y && y + rect.h <= platform.rect.y + platform.rect.h &&
-                velocityY >= 0) {
-                y = platform.rect.y - rect.h;
-                velocityY = 0;
-                onPlatform = true;
-                if (isJumping || isJumpingMid) {
-                    isJumpingEnd = true;
-                    isJumpingMid = false;
-                    isJumping = false;
-                    currentFrame = 0;
-                }
-                break;
+        if (velocityY >= 0 && grid.findGround(rect.x, rect.w, y + rect.h, platform)) {
+            y = platform.y - rect.h;
+            velocityY = 0;
+            onPlatform = true;
+            if (isJumping || isJumpingMid) {
+                isJumpingEnd = true;
+                isJumpingMid = false;
+                isJumping = false;
+                currentFrame = 0;
             }
         }
 
@@ -309,15 +278,30 @@ struct Player {
         }
     }
 
+    SDL_Rect attackRect() const {
+        SDL_Rect attackRect = rect;
+        attackRect.w = 10;
+        attackRect.h = rect.h / 2;
+        if (facingLeft) attackRect.x -= 30;
+        else attackRect.x += rect.w + 5;
+        return attackRect;
+    }
+
+    void publishBoxes(CombatWorld& combat) const {
+        SDL_Rect body = { static_cast<int>(x), static_cast<int>(y), rect.w, rect.h };
+        combat.addHurtbox(body, FACTION_PLAYER, OWNER_PLAYER, 0);
+        if (isAttacking) combat.addHitbox(attackRect(), FACTION_PLAYER, PLAYER_ATTACK_DAMAGE, OWNER_PLAYER, 0);
+    }
+
     void renderHealthBar(SDL_Renderer* renderer) {
         const int HEART_WIDTH = 33;
         const int BAR_WIDTH = 160;
         const int HEIGHT = 68;
 
         SDL_Rect heartRect = {10, 50, HEART_WIDTH, HEIGHT};
-        if (healthBarTexture) {
+        if (healthBarTexture.get()) {
             SDL_Rect heartSrcRect = {0, 0, HEART_WIDTH, HEIGHT};
-            SDL_RenderCopy(renderer, healthBarTexture, &heartSrcRect, &heartRect);
+            renderCopy(renderer, healthBarTexture, &heartSrcRect, &heartRect);
         } else {
             SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
             SDL_RenderFillRect(renderer, &heartRect);
@@ -326,9 +310,9 @@ struct Player {
         int healthWidth = static_cast<int>(BAR_WIDTH * (displayHealth / maxHealth));
         if (healthWidth < 0) healthWidth = 0;
         SDL_Rect healthBarRect = {10 + HEART_WIDTH, 50, healthWidth, HEIGHT};
-        if (healthBarTexture && healthWidth > 0) {
+        if (healthBarTexture.get() && healthWidth > 0) {
             SDL_Rect srcRect = {HEART_WIDTH, 0, healthWidth, HEIGHT};
-            SDL_RenderCopy(renderer, healthBarTexture, &srcRect, &healthBarRect);
+            renderCopy(renderer, healthBarTexture, &srcRect, &healthBarRect);
         } else if (healthWidth > 0) {
             SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
             SDL_RenderFillRect(renderer, &healthBarRect);
@@ -336,8 +320,8 @@ struct Player {
 
         if (healthWidth < BAR_WIDTH) {
             SDL_Rect emptyBarRect = {10 + HEART_WIDTH + healthWidth, 50, BAR_WIDTH - healthWidth, HEIGHT};
-            if (healthBarEmptyTexture) {
-                SDL_RenderCopy(renderer, healthBarEmptyTexture, NULL, &emptyBarRect);
+            if (healthBarEmptyTexture.get()) {
+                renderCopy(renderer, healthBarEmptyTexture, NULL, &emptyBarRect);
             } else {
                 SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
                 SDL_RenderFillRect(renderer, &emptyBarRect);
@@ -346,43 +330,44 @@ struct Player {
     }
 
     void render(SDL_Renderer* renderer, float cameraX) {
+        PROFILE_SCOPE("Player::render");
         SDL_Rect renderRect = rect;
         renderRect.x -= static_cast<int>(cameraX);
         SDL_RendererFlip flip = facingLeft ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
 
         if (isDying) {
             SDL_Rect srcRect = { (currentFrame % 8) * 80, 0, 80, 47 };
-            SDL_RenderCopyEx(renderer, deadTexture, &srcRect, &renderRect, 0, NULL, flip);
+            renderCopy(renderer, deadTexture, &srcRect, &renderRect, flip);
         } else if (isJumpingStart) {
             SDL_Rect srcRect = { (currentFrame % 4) * 64, 0, 64, 64 };
-            SDL_RenderCopyEx(renderer, jumpStartTexture, &srcRect, &renderRect, 0, NULL, flip);
+            renderCopy(renderer, jumpStartTexture, &srcRect, &renderRect, flip);
         } else if (isJumpingMid) {
             SDL_Rect srcRect = { (currentFrame % 8) * 64, 0, 64, 60 };
-            SDL_RenderCopyEx(renderer, jumpMidTexture, &srcRect, &renderRect, 0, NULL, flip);
+            renderCopy(renderer, jumpMidTexture, &srcRect, &renderRect, flip);
         } else if (isJumpingEnd) {
             SDL_Rect srcRect = { (currentFrame % 3) * 64, 0, 64, 64 };
-            SDL_RenderCopyEx(renderer, jumpEndTexture, &srcRect, &renderRect, 0, NULL, flip);
+            renderCopy(renderer, jumpEndTexture, &srcRect, &renderRect, flip);
         } else if (isAttacking) {
             SDL_Rect srcRect = { (currentFrame % 8) * 96, 0, 96, 64 };
-            SDL_RenderCopyEx(renderer, attackTexture, &srcRect, &renderRect, 0, NULL, flip);
+            renderCopy(renderer, attackTexture, &srcRect, &renderRect, flip);
         } else if (isMovingLeft || isMovingRight) {
             SDL_Rect srcRect = { (currentFrame % 8) * 80, 0, 80, 66 };
-            SDL_RenderCopyEx(renderer, runTexture, &srcRect, &renderRect, 0, NULL, flip);
+            renderCopy(renderer, runTexture, &srcRect, &renderRect, flip);
         } else {
             SDL_Rect srcRect = { (currentFrame % 4) * 64, 0, 64, 64 };
-            SDL_RenderCopyEx(renderer, idleTexture, &srcRect, &renderRect, 0, NULL, flip);
+            renderCopy(renderer, idleTexture, &srcRect, &renderRect, flip);
         }
     }
 
-    void cleanup() {
-        if (idleTexture) SDL_DestroyTexture(idleTexture);
-        if (runTexture) SDL_DestroyTexture(runTexture);
-        if (attackTexture) SDL_DestroyTexture(attackTexture);
-        if (jumpStartTexture) SDL_DestroyTexture(jumpStartTexture);
-        if (jumpMidTexture) SDL_DestroyTexture(jumpMidTexture);
-        if (jumpEndTexture) SDL_DestroyTexture(jumpEndTexture);
-        if (deadTexture) SDL_DestroyTexture(deadTexture);
-        if (healthBarTexture) SDL_DestroyTexture(healthBarTexture);
-        if (healthBarEmptyTexture) SDL_DestroyTexture(healthBarEmptyTexture);
+    void cleanup(TextureManager& textureManager) {
+        textureManager.release(idleTexture);
+        textureManager.release(runTexture);
+        textureManager.release(attackTexture);
+        textureManager.release(jumpStartTexture);
+        textureManager.release(jumpMidTexture);
+        textureManager.release(jumpEndTexture);
+        textureManager.release(deadTexture);
+        textureManager.release(healthBarTexture);
+        textureManager.release(healthBarEmptyTexture);
     }
 };
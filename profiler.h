@@ -0,0 +1,234 @@
+// Build với -DPROFILER_ENABLED=0 để PROFILE_* không sinh ra mã nào
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+const int PROFILER_RING_SIZE = 1 << 16;   // Mẫu mỗi luồng, luỹ thừa của 2; đầy thì ghi đè mẫu cũ nhất
+const int PROFILER_GRAPH_FRAMES = 240;
+const int PROFILER_MAX_PHASES = 8;
+const int PROFILER_GRAPH_HEIGHT = 120;
+const float PROFILER_PIXELS_PER_MS = 4.0f;
+const SDL_Keycode PROFILER_GRAPH_KEY = SDLK_F3;
+const SDL_Keycode PROFILER_DUMP_KEY = SDLK_F4;
+
+// Màu từng pha trên đồ thị theo thứ tự pha xuất hiện lần đầu; phần còn lại của frame màu xám
+const SDL_Color PROFILER_PHASE_COLORS[PROFILER_MAX_PHASES] = {
+    { 230, 80, 80, 255 }, { 90, 200, 90, 255 }, { 240, 200, 60, 255 }, { 80, 140, 240, 255 },
+    { 200, 100, 220, 255 }, { 80, 210, 210, 255 }, { 240, 140, 60, 255 }, { 250, 250, 250, 255 },
+};
+
+struct ProfileSample {
+    const char* name;   // Luôn là chuỗi hằng nên chỉ giữ con trỏ
+    Uint64 start;
+    Uint64 end;
+};
+
+// Vòng đệm riêng của một luồng: chỉ luồng đó ghi; head tăng sau khi mẫu đã ghi xong
+struct ProfilerThread {
+    SDL_threadID id;
+    bool isMain;
+    int depth;
+    SDL_atomic_t head;
+    std::vector<ProfileSample> ring;
+};
+
+struct ProfilerFrame {
+    float totalMs;
+    float phaseMs[PROFILER_MAX_PHASES];
+};
+
+// Các scope ghi vào vòng đệm của luồng mình. Scope ngoài cùng trên luồng chính là các pha của
+// vòng lặp chính; thời gian của chúng cộng dồn theo frame cho đồ thị (F3). F4 ghi file trace
+// mở được bằng chrome://tracing.
+struct Profiler {
+    SDL_SpinLock lock = 0;
+    std::vector<ProfilerThread*> threads;
+    SDL_threadID mainThread = 0;
+    Uint64 origin = 0;
+    Uint64 frameStart = 0;
+    double msPerTick = 0;
+    const char* phaseNames[PROFILER_MAX_PHASES] = {};
+    int phaseCount = 0;
+    ProfilerFrame current = {};
+    ProfilerFrame frames[PROFILER_GRAPH_FRAMES] = {};
+    int frameCursor = 0;
+    bool showGraph = false;
+
+    // Gọi trên luồng chính trước khi tạo các luồng khác; vòng đệm được cấp luôn để scope đầu tiên
+    // không phải trả giá cấp phát
+    void init() {
+        mainThread = SDL_ThreadID();
+        origin = SDL_GetPerformanceCounter();
+        frameStart = origin;
+        msPerTick = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+        thread();
+    }
+
+    ProfilerThread* thread() {
+        static thread_local ProfilerThread* self = nullptr;
+        if (!self) {
+            self = new ProfilerThread();
+            self->id = SDL_ThreadID();
+            self->isMain = self->id == mainThread;
+            self->depth = 0;
+            SDL_AtomicSet(&self->head, 0);
+            self->ring.resize(PROFILER_RING_SIZE);
+            SDL_AtomicLock(&lock);
+            threads.push_back(self);
+            SDL_AtomicUnlock(&lock);
+        }
+        return self;
+    }
+
+    void record(ProfilerThread* thread, const char* name, Uint64 start, Uint64 end) {
+        int head = SDL_AtomicGet(&thread->head);
+        thread->ring[head & (PROFILER_RING_SIZE - 1)] = { name, start, end };
+        SDL_AtomicSet(&thread->head, head + 1);
+        if (!thread->isMain || thread->depth != 0) return;
+
+        int phase = 0;
+        while (phase < phaseCount && phaseNames[phase] != name) phase++;
+        if (phase == phaseCount) {
+            if (phaseCount == PROFILER_MAX_PHASES) return;
+            phaseNames[phaseCount++] = name;
+        }
+        current.phaseMs[phase] += static_cast<float>((end - start) * msPerTick);
+    }
+
+    // Sau SDL_RenderPresent: chốt thời gian của frame vừa xong vào đồ thị
+    void endFrame() {
+        Uint64 now = SDL_GetPerformanceCounter();
+        current.totalMs = static_cast<float>((now - frameStart) * msPerTick);
+        frames[frameCursor] = current;
+        frameCursor = (frameCursor + 1) % PROFILER_GRAPH_FRAMES;
+        current = {};
+        frameStart = now;
+    }
+
+    // Phím của profiler không đi vào gameplay hay file ghi input
+    bool handleKey(SDL_Keycode key) {
+        if (key == PROFILER_GRAPH_KEY) {
+            showGraph = !showGraph;
+            if (showGraph) {
+                std::cout << "Profiler: graph on, phases:";
+                for (int i = 0; i < phaseCount; i++) std::cout << " " << i + 1 << "=" << phaseNames[i];
+                std::cout << std::endl;
+            }
+            return true;
+        }
+        if (key == PROFILER_DUMP_KEY) {
+            writeChromeTrace("profile.json");
+            return true;
+        }
+        return false;
+    }
+
+    // Cột chồng theo pha cho từng frame, frame mới nhất ở bên phải; vạch ngang là 16.7 ms
+    void renderGraph(SDL_Renderer* renderer) const {
+        if (!showGraph || !renderer) return;
+        int left = SCREEN_WIDTH - PROFILER_GRAPH_FRAMES - 10;
+        int bottom = SCREEN_HEIGHT - 10;
+        SDL_Rect background = { left, bottom - PROFILER_GRAPH_HEIGHT, PROFILER_GRAPH_FRAMES, PROFILER_GRAPH_HEIGHT };
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+        SDL_RenderFillRect(renderer, &background);
+
+        for (int i = 0; i < PROFILER_GRAPH_FRAMES; i++) {
+            const ProfilerFrame& frame = frames[(frameCursor + i) % PROFILER_GRAPH_FRAMES];
+            int y = bottom;
+            float phaseTotal = 0;
+            for (int phase = 0; phase <= phaseCount && y > background.y; phase++) {
+                float ms = phase < phaseCount ? frame.phaseMs[phase] : std::max(0.0f, frame.totalMs - phaseTotal);
+                int height = std::min(y - background.y, static_cast<int>(ms * PROFILER_PIXELS_PER_MS + 0.5f));
+                if (phase < phaseCount) {
+                    phaseTotal += ms;
+                    const SDL_Color& color = PROFILER_PHASE_COLORS[phase];
+                    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+                } else {
+                    SDL_SetRenderDrawColor(renderer, 110, 110, 110, 255);
+                }
+                if (height > 0) SDL_RenderDrawLine(renderer, left + i, y - 1, left + i, y - height);
+                y -= height;
+            }
+        }
+        int budgetY = bottom - static_cast<int>(1000.0f / 60.0f * PROFILER_PIXELS_PER_MS);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDrawLine(renderer, left, budgetY, left + PROFILER_GRAPH_FRAMES - 1, budgetY);
+    }
+
+    // Định dạng "Trace Event" của chrome://tracing: mỗi mẫu là một sự kiện "X", thời gian tính bằng µs.
+    // Luồng khác có thể vẫn đang ghi; mẫu bị ghi đè giữa chừng chỉ làm sai một sự kiện trong file.
+    bool writeChromeTrace(const std::string& path) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "❌ Không ghi được tệp: " << path << std::endl;
+            return false;
+        }
+        out.setf(std::ios::fixed);
+        out.precision(3);
+        double usPerTick = msPerTick * 1000.0;
+        size_t events = 0;
+        out << "{\"traceEvents\":[\n";
+        SDL_AtomicLock(&lock);
+        std::vector<ProfilerThread*> snapshot = threads;
+        SDL_AtomicUnlock(&lock);
+        for (size_t t = 0; t < snapshot.size(); t++) {
+            ProfilerThread* thread = snapshot[t];
+            out << (t == 0 ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":\"" << (thread->isMain ? "main" : "worker " + std::to_string(t)) << "\"}}";
+            int head = SDL_AtomicGet(&thread->head);
+            for (int i = std::max(0, head - PROFILER_RING_SIZE); i < head; i++) {
+                const ProfileSample& sample = thread->ring[i & (PROFILER_RING_SIZE - 1)];
+                out << ",\n{\"name\":\"" << sample.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t
+                    << ",\"ts\":" << (sample.start - origin) * usPerTick << ",\"dur\":" << (sample.end - sample.start) * usPerTick << "}";
+                events++;
+            }
+        }
+        out << "\n]}\n";
+        std::cout << "Profiler: wrote " << events << " events from " << snapshot.size() << " threads to " << path << std::endl;
+        return true;
+    }
+
+    void cleanup() {
+        SDL_AtomicLock(&lock);
+        for (ProfilerThread* thread : threads) delete thread;
+        threads.clear();
+        SDL_AtomicUnlock(&lock);
+    }
+};
+
+Profiler profiler;
+
+// Đo từ lúc tạo tới khi ra khỏi scope, hoặc tới end() nếu pha kết thúc trước cuối block
+struct ProfileScope {
+    ProfilerThread* thread;
+    const char* name;
+    Uint64 start;
+    bool open;
+
+    ProfileScope(const char* name) : thread(profiler.thread()), name(name), start(SDL_GetPerformanceCounter()), open(true) {
+        thread->depth++;
+    }
+
+    void end() {
+        if (!open) return;
+        open = false;
+        thread->depth--;
+        profiler.record(thread, name, start, SDL_GetPerformanceCounter());
+    }
+
+    ~ProfileScope() {
+        end();
+    }
+};
+
+#if PROFILER_ENABLED
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_JOIN(profileScope, __LINE__)(name)
+#define PROFILE_BEGIN(scope, name) ProfileScope scope(name)
+#define PROFILE_END(scope) scope.end()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_BEGIN(scope, name)
+#define PROFILE_END(scope)
+#endif
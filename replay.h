@@ -0,0 +1,211 @@
+// Ghi và phát lại input theo tick để tái hiện đúng một phiên chơi.
+// File .rec: ReplayFileHeader | ReplayEvent[eventCount] | uint64_t checksum[checksumCount]
+// Checksum thứ i là trạng thái thế giới sau (i + 1) * checksumInterval tick.
+const uint32_t REPLAY_VERSION = 1;
+const uint32_t REPLAY_CHECKSUM_INTERVAL = 30;
+const uint32_t REPLAY_KEY_UP = 0x80000000u;   // Bit cao của tick: phím nhả
+
+struct ReplayFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t seed;
+    uint32_t checksumInterval;
+    uint32_t eventCount;
+    uint32_t checksumCount;
+    uint64_t tickCount;
+};
+
+struct ReplayEvent {
+    uint32_t tick;   // Tick mà phím được áp dụng trước đó, kèm REPLAY_KEY_UP
+    int32_t key;
+};
+
+template <typename T>
+void hashValue(uint64_t& hash, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+// FNV-1a trên những trường quyết định gameplay (vị trí, máu, trạng thái hoạt ảnh); bỏ qua texture và con trỏ.
+// Kẻ địch được duyệt theo thứ tự slot để checksum không đổi khi swap-and-pop đảo vị trí hàng.
+uint64_t hashWorldState(const Player& player, const World& world, BulletPool& bulletPool) {
+    uint64_t hash = 14695981039346656037ull;
+    hashValue(hash, player.x);
+    hashValue(hash, player.y);
+    hashValue(hash, player.velocityY);
+    hashValue(hash, player.health);
+    hashValue(hash, player.lives);
+    hashValue(hash, player.currentFrame);
+    hashValue(hash, player.isDying);
+    hashValue(hash, player.isAttacking);
+    hashValue(hash, player.facingLeft);
+    hashValue(hash, randomState);
+    const EntityStore& entities = world.entities;
+    entities.enemies.forEachInSlotOrder([&](size_t i) {
+        const Enemy& enemy = entities.enemies.cold[i];
+        hashValue(hash, entities.enemies.x[i]);
+        hashValue(hash, entities.enemies.y[i]);
+        hashValue(hash, entities.enemies.hitCount[i]);
+        hashValue(hash, entities.enemies.currentFrame[i]);
+        hashValue(hash, entities.enemies.isDying[i]);
+        hashValue(hash, entities.enemies.isHurt[i]);
+        hashValue(hash, enemy.bulletCount);
+        for (int k = 0; k < enemy.bulletCount; k++) {
+            const Bullet& bullet = bulletPool.get(enemy.bulletSlots[k]);
+            hashValue(hash, bullet.x);
+            hashValue(hash, bullet.y);
+        }
+    });
+    entities.newEnemies.forEachInSlotOrder([&](size_t i) {
+        hashValue(hash, entities.newEnemies.x[i]);
+        hashValue(hash, entities.newEnemies.y[i]);
+        hashValue(hash, entities.newEnemies.hitCount[i]);
+        hashValue(hash, entities.newEnemies.currentFrame[i]);
+        hashValue(hash, entities.newEnemies.isDying[i]);
+    });
+    entities.newEnemies5.forEachInSlotOrder([&](size_t i) {
+        hashValue(hash, entities.newEnemies5.x[i]);
+        hashValue(hash, entities.newEnemies5.currentFrame[i]);
+        hashValue(hash, entities.newEnemies5.isMoving[i]);
+        hashValue(hash, entities.newEnemies5.cold[i].isEndScreen);
+    });
+    entities.bosses.forEachInSlotOrder([&](size_t i) {
+        hashValue(hash, entities.bosses.x[i]);
+        hashValue(hash, entities.bosses.y[i]);
+        hashValue(hash, entities.bosses.cold[i].health);
+        hashValue(hash, entities.bosses.currentFrame[i]);
+        hashValue(hash, entities.bosses.isDying[i]);
+    });
+    return hash;
+}
+
+struct InputRecorder {
+    std::string path;
+    uint32_t seed = 0;
+    std::vector<ReplayEvent> events;
+    std::vector<uint64_t> checksums;
+    uint64_t tickCount = 0;
+
+    bool isActive() const {
+        return !path.empty();
+    }
+
+    void start(const std::string& path, uint32_t seed) {
+        this->path = path;
+        this->seed = seed;
+        events.clear();
+        checksums.clear();
+        tickCount = 0;
+    }
+
+    void record(long long tick, SDL_Keycode key, bool down) {
+        events.push_back({ static_cast<uint32_t>(tick) | (down ? 0 : REPLAY_KEY_UP), static_cast<int32_t>(key) });
+    }
+
+    // Gọi sau mỗi tick; ticksDone là số tick đã chạy xong
+    void endTick(long long ticksDone, const Player& player, const World& world, BulletPool& bulletPool) {
+        tickCount = ticksDone;
+        if (ticksDone % REPLAY_CHECKSUM_INTERVAL == 0) checksums.push_back(hashWorldState(player, world, bulletPool));
+    }
+
+    bool save() const {
+        ReplayFileHeader header = {};
+        std::memcpy(header.magic, "HREC", 4);
+        header.version = REPLAY_VERSION;
+        header.seed = seed;
+        header.checksumInterval = REPLAY_CHECKSUM_INTERVAL;
+        header.eventCount = static_cast<uint32_t>(events.size());
+        header.checksumCount = static_cast<uint32_t>(checksums.size());
+        header.tickCount = tickCount;
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "❌ Không ghi được tệp replay: " << path << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(events.data()), events.size() * sizeof(ReplayEvent));
+        out.write(reinterpret_cast<const char*>(checksums.data()), checksums.size() * sizeof(uint64_t));
+        std::cout << "Record: " << tickCount << " ticks, " << events.size() << " key events, "
+                  << checksums.size() << " checksums -> " << path << std::endl;
+        return true;
+    }
+};
+
+struct InputReplayer {
+    ReplayFileHeader header = {};
+    std::vector<ReplayEvent> events;
+    std::vector<uint64_t> checksums;
+    size_t nextEvent = 0;
+    size_t checked = 0;
+    long long mismatchTick = -1;
+
+    bool isActive() const {
+        return header.version != 0;
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "❌ Không mở được tệp replay: " << path << std::endl;
+            return false;
+        }
+        ReplayFileHeader fileHeader;
+        if (!in.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader)) ||
+            std::memcmp(fileHeader.magic, "HREC", 4) != 0 || fileHeader.version != REPLAY_VERSION ||
+            fileHeader.checksumInterval == 0) {
+            std::cerr << "❌ " << path << " sai định dạng hoặc phiên bản" << std::endl;
+            return false;
+        }
+        events.resize(fileHeader.eventCount);
+        checksums.resize(fileHeader.checksumCount);
+        in.read(reinterpret_cast<char*>(events.data()), events.size() * sizeof(ReplayEvent));
+        in.read(reinterpret_cast<char*>(checksums.data()), checksums.size() * sizeof(uint64_t));
+        if (!in) {
+            std::cerr << "❌ " << path << " bị cắt cụt" << std::endl;
+            return false;
+        }
+        header = fileHeader;
+        return true;
+    }
+
+    // Đưa các phím đã ghi cho đúng tick này vào cùng đường xử lý như bàn phím thật
+    template <typename HandleKey>
+    void play(long long tick, HandleKey handleKey) {
+        while (nextEvent < events.size() && (events[nextEvent].tick & ~REPLAY_KEY_UP) == tick) {
+            const ReplayEvent& event = events[nextEvent++];
+            handleKey(static_cast<SDL_Keycode>(event.key), (event.tick & REPLAY_KEY_UP) == 0);
+        }
+    }
+
+    // Chỉ báo checksum lệch đầu tiên; trả về false từ lúc đó trở đi
+    bool endTick(long long ticksDone, const Player& player, const World& world, BulletPool& bulletPool) {
+        if (mismatchTick >= 0 || ticksDone % header.checksumInterval != 0) return mismatchTick < 0;
+        size_t index = static_cast<size_t>(ticksDone / header.checksumInterval) - 1;
+        if (index >= checksums.size()) return true;
+        uint64_t checksum = hashWorldState(player, world, bulletPool);
+        if (checksums[index] != checksum) {
+            mismatchTick = ticksDone;
+            std::cerr << "❌ Replay lệch ở tick " << ticksDone << ": checksum " << std::hex << checksum
+                      << " thay vì " << checksums[index] << std::dec << std::endl;
+            return false;
+        }
+        checked++;
+        return true;
+    }
+
+    bool isFinished(long long ticksDone) const {
+        return ticksDone >= static_cast<long long>(header.tickCount);
+    }
+
+    void printStats(long long ticksDone) const {
+        if (mismatchTick >= 0) {
+            std::cout << "Replay: diverged at tick " << mismatchTick << " after " << checked << " matching checksums" << std::endl;
+        } else {
+            std::cout << "Replay: " << ticksDone << " of " << header.tickCount << " ticks, "
+                      << checked << " of " << checksums.size() << " checksums matched" << std::endl;
+        }
+    }
+};
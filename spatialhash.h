@@ -0,0 +1,191 @@
+// Lưới đều băm theo ô cho các vật thể động (kẻ địch, boss, vật phẩm, đạn). Mỗi vật nằm trong ô chứa
+// góc trên trái của nó; di chuyển mà không đổi ô thì chỉ ghi lại hộp. Truy vấn hình chữ nhật hoặc
+// bán kính chỉ duyệt các ô quanh vùng hỏi, nên chi phí theo mật độ cục bộ chứ không theo tổng số vật.
+const float SPATIAL_CELL_SIZE = 128.0f;
+const uint32_t SPATIAL_NONE = 0;   // Id 0 không dùng: cột spatialId khởi tạo bằng 0 nghĩa là chưa có trong lưới
+
+enum SpatialKind : uint8_t {
+    SPATIAL_ENEMY,
+    SPATIAL_NEW_ENEMY,
+    SPATIAL_NEW_ENEMY5,
+    SPATIAL_BOSS,
+    SPATIAL_ITEM,
+    SPATIAL_BULLET
+};
+
+struct SpatialBox {
+    float x, y, w, h;
+};
+
+struct SpatialHit {
+    uint8_t kind;
+    uint32_t index;   // Hàng trong bảng của loại đó, chỉ số vật phẩm hoặc slot đạn
+};
+
+struct SpatialObject {
+    SpatialBox box;
+    uint32_t index;
+    uint8_t kind;
+    bool live;
+    int cellX, cellY;
+    uint32_t bucket;
+    uint32_t slot;    // Vị trí trong bucket, để xóa bằng swap-and-pop
+};
+
+bool spatialOverlap(const SpatialBox& a, const SpatialBox& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+struct SpatialHash {
+    float cellSize = SPATIAL_CELL_SIZE;
+    std::vector<std::vector<uint32_t>> buckets;
+    std::vector<SpatialObject> objects;
+    std::vector<uint32_t> freeIds;
+    size_t liveCount = 0;
+    float maxWidth = 0;    // Vật lớn nhất từng chèn: truy vấn nới vùng tìm sang trái/lên trên chừng này
+    float maxHeight = 0;
+    long long cellChanges = 0;
+    long long queries = 0;
+    long long candidates = 0;
+
+    void init(float cellSize = SPATIAL_CELL_SIZE, size_t bucketCount = 1024) {
+        this->cellSize = cellSize;
+        buckets.assign(bucketCount, {});
+        objects.assign(1, SpatialObject{});
+        freeIds.clear();
+        liveCount = 0;
+        maxWidth = 0;
+        maxHeight = 0;
+    }
+
+    void clear() {
+        init(cellSize);
+    }
+
+    int cellOf(float value) const {
+        return static_cast<int>(std::floor(value / cellSize));
+    }
+
+    // Số bucket luôn là lũy thừa của 2; nhiều ô khác nhau có thể chung bucket, truy vấn lọc theo ô
+    uint32_t bucketOf(int cellX, int cellY) const {
+        uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellY) * 19349663u;
+        return hash & static_cast<uint32_t>(buckets.size() - 1);
+    }
+
+    void link(uint32_t id) {
+        SpatialObject& object = objects[id];
+        object.cellX = cellOf(object.box.x);
+        object.cellY = cellOf(object.box.y);
+        object.bucket = bucketOf(object.cellX, object.cellY);
+        std::vector<uint32_t>& bucket = buckets[object.bucket];
+        object.slot = static_cast<uint32_t>(bucket.size());
+        bucket.push_back(id);
+    }
+
+    void unlink(uint32_t id) {
+        const SpatialObject& object = objects[id];
+        std::vector<uint32_t>& bucket = buckets[object.bucket];
+        uint32_t last = bucket.back();
+        bucket[object.slot] = last;
+        objects[last].slot = object.slot;
+        bucket.pop_back();
+    }
+
+    // Gấp đôi số bucket khi trung bình mỗi bucket quá 2 vật
+    void growIfNeeded() {
+        if (liveCount <= buckets.size() * 2) return;
+        buckets.assign(buckets.size() * 2, {});
+        for (uint32_t id = 1; id < objects.size(); id++) {
+            if (objects[id].live) link(id);
+        }
+    }
+
+    uint32_t insert(SpatialKind kind, uint32_t index, const SpatialBox& box) {
+        if (buckets.empty()) init(cellSize);
+        uint32_t id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+        } else {
+            id = static_cast<uint32_t>(objects.size());
+            objects.emplace_back();
+        }
+        SpatialObject& object = objects[id];
+        object.box = box;
+        object.index = index;
+        object.kind = kind;
+        object.live = true;
+        maxWidth = std::max(maxWidth, box.w);
+        maxHeight = std::max(maxHeight, box.h);
+        liveCount++;
+        link(id);
+        growIfNeeded();
+        return id;
+    }
+
+    // Gọi mỗi tick cho vật đã di chuyển; index cũng được ghi lại vì hàng có thể đã bị dồn
+    void update(uint32_t id, uint32_t index, const SpatialBox& box) {
+        SpatialObject& object = objects[id];
+        object.box = box;
+        object.index = index;
+        maxWidth = std::max(maxWidth, box.w);
+        maxHeight = std::max(maxHeight, box.h);
+        if (cellOf(box.x) == object.cellX && cellOf(box.y) == object.cellY) return;
+        unlink(id);
+        link(id);
+        cellChanges++;
+    }
+
+    void remove(uint32_t id) {
+        if (id == SPATIAL_NONE || !objects[id].live) return;
+        unlink(id);
+        objects[id].live = false;
+        freeIds.push_back(id);
+        liveCount--;
+    }
+
+    // Gọi visit(object) cho mọi vật có góc trên trái nằm trong các ô có thể chạm vùng area
+    template <typename Visit>
+    void forEachNear(const SpatialBox& area, Visit visit) {
+        queries++;
+        if (liveCount == 0) return;
+        int firstX = cellOf(area.x - maxWidth);
+        int lastX = cellOf(area.x + area.w);
+        int firstY = cellOf(area.y - maxHeight);
+        int lastY = cellOf(area.y + area.h);
+        for (int cellY = firstY; cellY <= lastY; cellY++) {
+            for (int cellX = firstX; cellX <= lastX; cellX++) {
+                for (uint32_t id : buckets[bucketOf(cellX, cellY)]) {
+                    const SpatialObject& object = objects[id];
+                    if (object.cellX != cellX || object.cellY != cellY) continue;
+                    candidates++;
+                    visit(object);
+                }
+            }
+        }
+    }
+
+    void queryRect(const SpatialBox& area, std::vector<SpatialHit>& hits) {
+        forEachNear(area, [&](const SpatialObject& object) {
+            if (spatialOverlap(object.box, area)) hits.push_back({ object.kind, object.index });
+        });
+    }
+
+    // Vật có hộp giao với hình tròn tâm (x, y)
+    void queryRadius(float x, float y, float radius, std::vector<SpatialHit>& hits) {
+        SpatialBox area = { x - radius, y - radius, radius * 2, radius * 2 };
+        forEachNear(area, [&](const SpatialObject& object) {
+            float nearestX = std::max(object.box.x, std::min(x, object.box.x + object.box.w));
+            float nearestY = std::max(object.box.y, std::min(y, object.box.y + object.box.h));
+            float dx = x - nearestX;
+            float dy = y - nearestY;
+            if (dx * dx + dy * dy <= radius * radius) hits.push_back({ object.kind, object.index });
+        });
+    }
+
+    void printStats() const {
+        std::cout << "Spatial: " << liveCount << " objects in " << buckets.size() << " buckets, "
+                  << cellChanges << " cell changes, " << queries << " queries, "
+                  << (queries ? static_cast<double>(candidates) / queries : 0.0) << " candidates/query" << std::endl;
+    }
+};
@@ -0,0 +1,108 @@
+const int TICK_RATE = 60;                           // Tốc độ, trọng lực và số khung hoạt ảnh đều được chỉnh theo tick 60 Hz
+const double TICK_SECONDS = 1.0 / TICK_RATE;
+const double MAX_FRAME_SECONDS = 0.25;              // Máy bị treo lâu thì game chậm lại chứ không dồn hàng chục tick
+const float TELEPORT_DISTANCE = SCREEN_WIDTH / 2;   // Dời xa hơn thế trong một tick (hồi sinh, đổi level) thì không nội suy
+const long long HEADLESS_DEFAULT_TICKS = 60LL * 60 * TICK_RATE;   // --headless không kèm số tick: một giờ chơi
+const int HEADLESS_TICKS_PER_FRAME = 1024;          // Headless không vẽ nên chạy nhiều tick mỗi vòng lặp
+
+// Mô phỏng chạy theo tick cố định, tách khỏi việc vẽ: thời gian thực dồn vào accumulator
+// rồi được tiêu theo từng TICK_SECONDS, phần dư dùng để nội suy lúc vẽ.
+struct FixedTimestep {
+    Uint64 lastCounter;
+    double accumulator;
+    long long ticks;
+    long long frames;
+    int maxTicksPerFrame;
+
+    void init() {
+        lastCounter = SDL_GetPerformanceCounter();
+        accumulator = 0;
+        ticks = 0;
+        frames = 0;
+        maxTicksPerFrame = 0;
+    }
+
+    // Số tick phải chạy cho khoảng thời gian thực kể từ frame trước
+    int advance() {
+        Uint64 now = SDL_GetPerformanceCounter();
+        double elapsed = static_cast<double>(now - lastCounter) / SDL_GetPerformanceFrequency();
+        lastCounter = now;
+        accumulator += std::min(elapsed, MAX_FRAME_SECONDS);
+        int count = static_cast<int>(accumulator / TICK_SECONDS);
+        accumulator -= count * TICK_SECONDS;
+        ticks += count;
+        frames++;
+        maxTicksPerFrame = std::max(maxTicksPerFrame, count);
+        return count;
+    }
+
+    // Headless: không theo thời gian thực, chạy ngay count tick
+    int advanceFixed(int count) {
+        ticks += count;
+        frames++;
+        maxTicksPerFrame = std::max(maxTicksPerFrame, count);
+        return count;
+    }
+
+    double elapsedSeconds(Uint64 since) const {
+        return static_cast<double>(SDL_GetPerformanceCounter() - since) / SDL_GetPerformanceFrequency();
+    }
+
+    // Vị trí giữa tick trước (0) và tick hiện tại (1)
+    float alpha() const {
+        return static_cast<float>(accumulator / TICK_SECONDS);
+    }
+
+    void printStats() const {
+        if (frames == 0) return;
+        std::cout << "Timestep: " << ticks << " ticks at " << TICK_RATE << " Hz over " << frames << " frames, "
+                  << static_cast<double>(ticks) / frames << " ticks/frame (max " << maxTicksPerFrame << ")" << std::endl;
+    }
+};
+
+template <typename T>
+void storePrevious(T& entity) {
+    entity.previousX = entity.x;
+    entity.previousY = entity.y;
+}
+
+// Trong lúc vẽ, thực thể được dời tạm tới vị trí nội suy; restore() trả lại trạng thái mô phỏng
+struct Interpolator {
+    struct Saved {
+        float* x;
+        float* y;
+        float valueX;
+        float valueY;
+    };
+    std::vector<Saved> saved;
+    float alpha;
+
+    float lerp(float previous, float current) const {
+        if (std::abs(current - previous) > TELEPORT_DISTANCE) return current;
+        return previous + (current - previous) * alpha;
+    }
+
+    void apply(float& x, float& y, float previousX, float previousY) {
+        saved.push_back({ &x, &y, x, y });
+        x = lerp(previousX, x);
+        y = lerp(previousY, y);
+    }
+
+    template <typename T>
+    void apply(T& entity) {
+        apply(entity.x, entity.y, entity.previousX, entity.previousY);
+    }
+
+    template <typename Cold>
+    void apply(EntityColumns<Cold>& columns) {
+        for (size_t i = 0; i < columns.size(); i++) apply(columns.x[i], columns.y[i], columns.previousX[i], columns.previousY[i]);
+    }
+
+    void restore() {
+        for (auto it = saved.rbegin(); it != saved.rend(); ++it) {
+            *it->x = it->valueX;
+            *it->y = it->valueY;
+        }
+        saved.clear();
+    }
+};
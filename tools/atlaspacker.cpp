@@ -0,0 +1,125 @@
+// Gộp tất cả assets/*.png thành vài atlas lớn và sinh bảng frame assets/atlas.txt.
+// Build: g++ -std=c++17 -O2 tools/atlaspacker.cpp -lSDL2 -lSDL2_image -o atlaspacker
+// Chạy từ thư mục gốc: ./atlaspacker [--page-size 2048] [--padding 2]
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+const std::string ASSETS_PATH = "assets/";
+
+struct Sheet {
+    std::string name;
+    SDL_Surface* surface;
+    int page;
+    SDL_Rect rect;
+};
+
+// Xếp theo từng kệ: sheet cao trước, đầy hàng thì xuống kệ mới, đầy trang thì sang trang mới
+int packShelves(std::vector<Sheet*>& sheets, int pageSize, int padding) {
+    int page = 0;
+    int cursorX = padding;
+    int cursorY = padding;
+    int shelfHeight = 0;
+    for (Sheet* sheet : sheets) {
+        int w = sheet->surface->w;
+        int h = sheet->surface->h;
+        if (cursorX + w + padding > pageSize) {
+            cursorX = padding;
+            cursorY += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+        if (cursorY + h + padding > pageSize) {
+            page++;
+            cursorX = padding;
+            cursorY = padding;
+            shelfHeight = 0;
+        }
+        sheet->page = page;
+        sheet->rect = { cursorX, cursorY, w, h };
+        cursorX += w + padding;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    return sheets.empty() ? 0 : page + 1;
+}
+
+int main(int argc, char* argv[]) {
+    int pageSize = 2048;
+    int padding = 2;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--page-size") pageSize = std::atoi(argv[++i]);
+        else if (arg == "--padding") padding = std::atoi(argv[++i]);
+    }
+
+    if (IMG_Init(IMG_INIT_PNG) != IMG_INIT_PNG) {
+        std::cerr << "❌ Khởi tạo IMG thất bại: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+
+    std::vector<Sheet> sheets;
+    for (const auto& file : std::filesystem::directory_iterator(ASSETS_PATH)) {
+        std::string name = file.path().filename().string();
+        if (file.path().extension() != ".png" || name.rfind("atlas", 0) == 0) continue;
+        SDL_Surface* loaded = IMG_Load((ASSETS_PATH + name).c_str());
+        if (!loaded) {
+            std::cerr << "❌ Không tải được " << name << ": " << IMG_GetError() << std::endl;
+            continue;
+        }
+        SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if (surface->w + 2 * padding > pageSize || surface->h + 2 * padding > pageSize) {
+            std::cerr << "❌ " << name << " lớn hơn trang atlas " << pageSize << "px, bỏ qua" << std::endl;
+            SDL_FreeSurface(surface);
+            continue;
+        }
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        sheets.push_back({ name, surface, 0, { 0, 0, 0, 0 } });
+    }
+
+    std::vector<Sheet*> order;
+    for (auto& sheet : sheets) order.push_back(&sheet);
+    std::sort(order.begin(), order.end(), [](const Sheet* a, const Sheet* b) {
+        if (a->surface->h != b->surface->h) return a->surface->h > b->surface->h;
+        return a->name < b->name;
+    });
+    int pageCount = packShelves(order, pageSize, padding);
+
+    std::ofstream table(ASSETS_PATH + "atlas.txt");
+    table << "# name page x y w h\n";
+    table << "pages " << pageCount << "\n";
+    long long packedArea = 0;
+    for (int page = 0; page < pageCount; page++) {
+        SDL_Surface* pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32);
+        for (const auto& sheet : sheets) {
+            if (sheet.page != page) continue;
+            SDL_Rect dst = sheet.rect;
+            SDL_BlitSurface(sheet.surface, NULL, pageSurface, &dst);
+        }
+        std::string pageName = "atlas" + std::to_string(page) + ".png";
+        if (IMG_SavePNG(pageSurface, (ASSETS_PATH + pageName).c_str()) != 0) {
+            std::cerr << "❌ Không ghi được " << pageName << ": " << IMG_GetError() << std::endl;
+        }
+        SDL_FreeSurface(pageSurface);
+        table << "page " << page << " " << pageName << "\n";
+    }
+    for (const auto& sheet : sheets) {
+        table << "sheet " << sheet.name << " " << sheet.page << " " << sheet.rect.x << " " << sheet.rect.y
+              << " " << sheet.rect.w << " " << sheet.rect.h << "\n";
+        packedArea += static_cast<long long>(sheet.rect.w) * sheet.rect.h;
+        SDL_FreeSurface(sheet.surface);
+    }
+
+    std::cout << "Packed " << sheets.size() << " sheets into " << pageCount << " page(s) of "
+              << pageSize << "x" << pageSize << ", fill "
+              << (pageCount ? packedArea * 100 / (static_cast<long long>(pageCount) * pageSize * pageSize) : 0)
+              << "%" << std::endl;
+
+    IMG_Quit();
+    return 0;
+}
@@ -0,0 +1,171 @@
+// Đóng gói toàn bộ assets/ vào assets/assets.bundle: PNG được giải mã sẵn sang định dạng pixel
+// của renderer, các file khác (font, nhạc, level) được chép nguyên.
+// Build: g++ -std=c++17 -O2 tools/bundler.cpp -lSDL2 -lSDL2_image -o bundler
+// Chạy từ thư mục gốc: ./bundler [--format argb|abgr]
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const std::string ASSETS_PATH = "assets/";
+#include "../mappedfile.h"
+#include "../bundle.h"
+
+const std::string BUNDLE_FILE = "assets.bundle";
+
+// Hỏi renderer mặc định xem nó dùng định dạng texture nào để khỏi phải chuyển đổi lúc chạy game
+uint32_t detectRendererFormat() {
+    uint32_t format = SDL_PIXELFORMAT_ARGB8888;
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) return format;
+    SDL_Window* window = SDL_CreateWindow("bundler", 0, 0, 16, 16, SDL_WINDOW_HIDDEN);
+    SDL_Renderer* renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : nullptr;
+    SDL_RendererInfo info;
+    if (renderer && SDL_GetRendererInfo(renderer, &info) == 0 && info.num_texture_formats > 0 &&
+        SDL_BYTESPERPIXEL(info.texture_formats[0]) == 4) {
+        format = info.texture_formats[0];
+    }
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (window) SDL_DestroyWindow(window);
+    SDL_Quit();
+    return format;
+}
+
+void padTo16(std::ofstream& out) {
+    static const char zeros[16] = {};
+    std::streamoff position = out.tellp();
+    if (position % 16) out.write(zeros, 16 - position % 16);
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t format = 0;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format") {
+            std::string value = argv[++i];
+            format = value == "abgr" ? SDL_PIXELFORMAT_ABGR8888 : SDL_PIXELFORMAT_ARGB8888;
+        }
+    }
+    if (!format) format = detectRendererFormat();
+
+    if (IMG_Init(IMG_INIT_PNG) != IMG_INIT_PNG) {
+        std::cerr << "❌ Khởi tạo IMG thất bại: " << IMG_GetError() << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> names;
+    for (const auto& file : std::filesystem::directory_iterator(ASSETS_PATH)) {
+        std::string name = file.path().filename().string();
+        if (!file.is_regular_file() || name == BUNDLE_FILE) continue;
+        if (name.size() >= BUNDLE_NAME_SIZE) {
+            std::cerr << "❌ Tên file quá dài, bỏ qua: " << name << std::endl;
+            continue;
+        }
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+
+    uint32_t capacity = 16;
+    while (capacity < names.size() * 2) capacity *= 2;
+    std::vector<BundleEntry> table(capacity);
+    std::memset(table.data(), 0, capacity * sizeof(BundleEntry));
+
+    std::string outPath = ASSETS_PATH + BUNDLE_FILE;
+    std::ofstream out(outPath, std::ios::binary);
+    BundleHeader header = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t pixelBytes = 0;
+    uint64_t rawBytes = 0;
+    for (const auto& name : names) {
+        std::string path = ASSETS_PATH + name;
+        BundleEntry entry = {};
+        std::strncpy(entry.name, name.c_str(), BUNDLE_NAME_SIZE - 1);
+        entry.hash = bundleHash(name);
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0) {
+            entry.sourceTime = static_cast<int64_t>(info.st_mtime);
+            entry.sourceSize = static_cast<uint64_t>(info.st_size);
+        }
+
+        padTo16(out);
+        entry.offset = static_cast<uint64_t>(out.tellp());
+        if (std::filesystem::path(name).extension() == ".png") {
+            SDL_Surface* loaded = IMG_Load(path.c_str());
+            SDL_Surface* surface = loaded ? SDL_ConvertSurfaceFormat(loaded, format, 0) : nullptr;
+            if (loaded) SDL_FreeSurface(loaded);
+            if (!surface) {
+                std::cerr << "❌ Không tải được " << name << ": " << IMG_GetError() << std::endl;
+                continue;
+            }
+            entry.kind = BUNDLE_KIND_PIXELS;
+            entry.width = surface->w;
+            entry.height = surface->h;
+            entry.pitch = surface->w * 4;
+            SDL_LockSurface(surface);
+            for (int y = 0; y < surface->h; y++) {
+                out.write(static_cast<const char*>(surface->pixels) + y * surface->pitch, entry.pitch);
+            }
+            SDL_UnlockSurface(surface);
+            SDL_FreeSurface(surface);
+            entry.size = static_cast<uint64_t>(entry.pitch) * entry.height;
+            pixelBytes += entry.size;
+        } else {
+            std::ifstream in(path, std::ios::binary);
+            std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            out.write(bytes.data(), bytes.size());
+            entry.kind = BUNDLE_KIND_RAW;
+            entry.size = bytes.size();
+            rawBytes += entry.size;
+        }
+
+        uint32_t slot = static_cast<uint32_t>(entry.hash) & (capacity - 1);
+        while (table[slot].hash) slot = (slot + 1) & (capacity - 1);
+        table[slot] = entry;
+        header.entryCount++;
+    }
+
+    padTo16(out);
+    std::memcpy(header.magic, "HBDL", 4);
+    header.version = BUNDLE_VERSION;
+    header.pixelFormat = format;
+    header.indexCapacity = capacity;
+    header.indexOffset = static_cast<uint64_t>(out.tellp());
+    out.write(reinterpret_cast<const char*>(table.data()), capacity * sizeof(BundleEntry));
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+
+    AssetBundle check;
+    if (!check.open(outPath)) {
+        std::cerr << "❌ Bundle vừa ghi không đọc lại được" << std::endl;
+        return 1;
+    }
+    for (const auto& name : names) {
+        if (!check.find(name)) std::cerr << "❌ Thiếu " << name << " trong bundle" << std::endl;
+    }
+    check.close();
+
+    std::cout << "Wrote " << outPath << ": " << header.entryCount << " assets, "
+              << pixelBytes / 1024 << " KB pixels (" << SDL_GetPixelFormatName(format) << "), "
+              << rawBytes / 1024 << " KB raw" << std::endl;
+
+    IMG_Quit();
+    return 0;
+}
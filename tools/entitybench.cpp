@@ -0,0 +1,340 @@
+// Đo thông lượng update và cull của kẻ địch: bố cục cũ (mảng struct) so với EntityColumns (mảng cột).
+// Build: g++ -std=c++17 -O2 tools/entitybench.cpp -lSDL2 -lSDL2_image -lSDL2_mixer -lSDL2_ttf -o entitybench
+// Chạy từ thư mục gốc: ./entitybench [--ticks 600] [số kẻ địch ...]   (mặc định 10000 100000)
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <SDL_ttf.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <sstream>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include <chrono>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "../const.h"
+#include "../mappedfile.h"
+#include "../bundle.h"
+#include "../level.h"
+#include "../atlas.h"
+#include "../open.h"
+#include "../assetloader.h"
+#include "../profiler.h"
+#include "../jobs.h"
+#include "../camera.h"
+#include "../platform.h"
+#include "../door.h"
+#include "../chunks.h"
+#include "../collision.h"
+#include "../entitystore.h"
+#include "../bullet.h"
+#include "../spatialhash.h"
+#include "../item.h"
+#include "../patrol.h"
+#include "../combat.h"
+#include "../timestep.h"
+#include "../newenemy5.h"
+#include "../enemy.h"
+#include "../newenemy4.h"
+#include "../boss.h"
+#include "../world.h"
+
+// Bố cục Enemy trước khi tách cột: trường nóng nằm lẫn với texture và mảng đạn trong cùng struct
+struct AosEnemy {
+    float x, y;
+    float previousX, previousY;
+    float speed;
+    bool movingRight;
+    float min_x, max_x;
+    TextureHandle texture;
+    TextureHandle attackTexture;
+    TextureHandle hurtTexture;
+    TextureHandle dyingTexture;
+    int currentFrame;
+    int frameCount;
+    int attackFrameCount;
+    int hurtFrameCount;
+    int dyingFrameCount;
+    int frameDelay;
+    int attackFrameDelay;
+    int hurtFrameDelay;
+    int dyingFrameDelay;
+    int frameTimer;
+    bool isAttacking;
+    bool isHurt;
+    bool isDying;
+    bool toRemove;
+    int hitCount;
+    int bulletSlots[MAX_ENEMY_BULLETS];
+    int bulletCount;
+    int shootTimer;
+    int shootDelay;
+    int attackCooldown;
+    int attackCooldownMax;
+
+    void init(float start_x, float start_y, float min_x, float max_x) {
+        x = start_x;
+        y = start_y;
+        previousX = x;
+        previousY = y;
+        speed = 1.2f;
+        movingRight = true;
+        this->min_x = min_x;
+        this->max_x = max_x;
+        currentFrame = 0;
+        frameCount = 4;
+        attackFrameCount = 8;
+        hurtFrameCount = 4;
+        dyingFrameCount = 6;
+        frameDelay = 8;
+        attackFrameDelay = 6;
+        hurtFrameDelay = 4;
+        dyingFrameDelay = 4;
+        frameTimer = 0;
+        isAttacking = false;
+        isHurt = false;
+        isDying = false;
+        toRemove = false;
+        hitCount = 0;
+        bulletCount = 0;
+        shootTimer = 0;
+        shootDelay = 1;
+        attackCooldown = 0;
+        attackCooldownMax = 60;
+    }
+
+    // Nhánh tuần tra của Enemy::update cũ (người chơi ở xa nên không bắn)
+    void update(float playerX) {
+        if (isDying) {
+            frameTimer++;
+            if (frameTimer >= dyingFrameDelay) {
+                frameTimer = 0;
+                currentFrame++;
+                if (currentFrame >= dyingFrameCount) toRemove = true;
+            }
+        } else if (isHurt) {
+            frameTimer++;
+            if (frameTimer >= hurtFrameDelay) {
+                frameTimer = 0;
+                currentFrame++;
+                if (currentFrame >= hurtFrameCount) {
+                    isHurt = false;
+                    currentFrame = 0;
+                }
+            }
+        } else if (isAttacking) {
+            frameTimer++;
+            if (frameTimer >= attackFrameDelay) {
+                frameTimer = 0;
+                currentFrame++;
+                if (currentFrame >= attackFrameCount) {
+                    isAttacking = false;
+                    currentFrame = 0;
+                }
+            }
+        } else if (!movingRight && std::abs(playerX - x) < 200) {
+            isAttacking = true;
+            currentFrame = 0;
+        } else {
+            if (movingRight) {
+                x += speed;
+                if (x >= max_x) {
+                    x = max_x;
+                    movingRight = false;
+                }
+            } else {
+                x -= speed;
+                if (x <= min_x) {
+                    x = min_x;
+                    movingRight = true;
+                }
+            }
+            frameTimer++;
+            if (frameTimer >= frameDelay) {
+                frameTimer = 0;
+                currentFrame = (currentFrame + 1) % frameCount;
+            }
+        }
+        if (attackCooldown > 0) attackCooldown--;
+    }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printResult(const char* name, size_t count, int ticks, double seconds) {
+    double updates = static_cast<double>(count) * ticks;
+    std::cout << "  " << name << ": " << seconds * 1000.0 << " ms, "
+              << seconds * 1e9 / updates << " ns/entity, "
+              << updates / seconds / 1e6 << " M entity-ticks/s" << std::endl;
+}
+
+// Handle phải theo hàng khi swap-and-pop dời nó, mất hiệu lực sau eraseRow/clear() của chính nó,
+// và slot được tái sử dụng không nhận handle của thế hệ cũ
+bool checkHandles() {
+    EntityColumns<Enemy> columns;
+    EntityHandle handles[4];
+    for (int i = 0; i < 4; i++) {
+        size_t row = columns.add(static_cast<float>(i), 0.0f, 0.0f, 100.0f, 1.0f);
+        columns.cold[row].bulletCount = 0;
+        handles[i] = columns.handleOf(row);
+    }
+    auto at = [&columns](EntityHandle handle, float x) {
+        int row = columns.rowOf(handle);
+        return row >= 0 && columns.x[row] == x;
+    };
+    // Hàng 0 bị xóa: hàng cuối (x = 3) chuyển vào hàng 0
+    columns.eraseRow(0);
+    bool ok = columns.rowOf(handles[0]) < 0 && at(handles[1], 1) && at(handles[2], 2) && at(handles[3], 3) &&
+              columns.rowOf(handles[3]) == 0;
+    size_t row = columns.add(4.0f, 0.0f, 0.0f, 100.0f, 1.0f);
+    columns.cold[row].bulletCount = 0;
+    EntityHandle reused = columns.handleOf(row);
+    ok = ok && reused.slot == handles[0].slot && reused.generation != handles[0].generation &&
+         columns.rowOf(handles[0]) < 0 && at(reused, 4);
+    columns.clear();
+    for (EntityHandle handle : handles) ok = ok && columns.rowOf(handle) < 0;
+    ok = ok && columns.rowOf(reused) < 0;
+    return ok;
+}
+
+void runBenchmark(size_t count, int ticks, TextureManager& textureManager, BulletPool& bulletPool) {
+    // Đoạn tuần tra ngẫu nhiên nhưng cố định, trải dọc một level dài
+    seedRandom(12345);
+    std::vector<float> starts(count), widths(count);
+    for (size_t i = 0; i < count; i++) {
+        starts[i] = static_cast<float>(nextRandom() % 2000000);
+        widths[i] = static_cast<float>(50 + nextRandom() % 400);
+    }
+    const float playerX = -100000.0f;
+
+    std::vector<AosEnemy> aos(count);
+    for (size_t i = 0; i < count; i++) aos[i].init(starts[i], 500.0f, starts[i], starts[i] + widths[i]);
+    EntityColumns<Enemy> columns;
+    for (size_t i = 0; i < count; i++) Enemy::spawn(columns, starts[i], 500.0f, starts[i], starts[i] + widths[i], textureManager);
+
+    std::cout << count << " enemies, " << ticks << " ticks (AoS " << sizeof(AosEnemy) << " B/entity, SoA hot "
+              << 7 * sizeof(float) + 4 * sizeof(int) + 8 * sizeof(uint8_t) + 2 * sizeof(uint32_t) << " B/entity + cold " << sizeof(Enemy) << " B)" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        for (auto& enemy : aos) enemy.update(playerX);
+    }
+    double aosUpdate = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        Enemy::update(columns, 0, columns.size(), playerX, 0.0f);
+    }
+    double soaUpdate = secondsSince(start);
+
+    bool same = true;
+    for (size_t i = 0; i < count && same; i++) {
+        same = aos[i].x == columns.x[i] && aos[i].currentFrame == columns.currentFrame[i];
+    }
+
+    // Cull: đếm số kẻ địch nằm trong màn hình khi camera quét qua level
+    size_t aosVisible = 0;
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        float cameraX = static_cast<float>(t) * 3000.0f;
+        for (const auto& enemy : aos) {
+            float screenX = enemy.x - cameraX;
+            if (screenX + 64 > 0 && screenX < SCREEN_WIDTH) aosVisible++;
+        }
+    }
+    double aosCull = secondsSince(start);
+
+    size_t soaVisible = 0;
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        float cameraX = static_cast<float>(t) * 3000.0f;
+        for (float x : columns.x) {
+            float screenX = x - cameraX;
+            if (screenX + 64 > 0 && screenX < SCREEN_WIDTH) soaVisible++;
+        }
+    }
+    double soaCull = secondsSince(start);
+
+    printResult("update AoS", count, ticks, aosUpdate);
+    printResult("update SoA", count, ticks, soaUpdate);
+    printResult("cull   AoS", count, ticks, aosCull);
+    printResult("cull   SoA", count, ticks, soaCull);
+    std::cout << "  speedup: update " << aosUpdate / soaUpdate << "x, cull " << aosCull / soaCull << "x, "
+              << (same && aosVisible == soaVisible ? "results identical" : "RESULTS DIFFER") << std::endl;
+
+    // Xóa: mỗi tick bỏ chừng 0.5% số kẻ địch rồi spawn bù. Bố cục cũ dùng erase(remove_if) dồn cả mảng,
+    // slot map chuyển hàng cuối vào từng chỗ trống
+    int removeTicks = std::max(1, ticks / 10);
+    size_t removedAos = 0, removedSoa = 0;
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < removeTicks; t++) {
+        for (size_t i = 0; i < aos.size(); i++) aos[i].toRemove = (i * 7 + t) % 200 == 0;
+        size_t before = aos.size();
+        aos.erase(std::remove_if(aos.begin(), aos.end(), [](const AosEnemy& enemy) { return enemy.toRemove; }), aos.end());
+        removedAos += before - aos.size();
+        while (aos.size() < before) {
+            aos.emplace_back();
+            aos.back().init(starts[aos.size() - 1], 500.0f, starts[aos.size() - 1], starts[aos.size() - 1] + widths[aos.size() - 1]);
+        }
+    }
+    double aosRemove = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < removeTicks; t++) {
+        for (size_t i = 0; i < columns.size(); i++) columns.toRemove[i] = (i * 7 + t) % 200 == 0;
+        size_t before = columns.size();
+        removedSoa += columns.removeMarked([](size_t) {});
+        while (columns.size() < before) {
+            size_t i = columns.add(starts[columns.size()], 500.0f, starts[columns.size()], starts[columns.size()] + widths[columns.size()], 1.2f);
+            columns.cold[i].bulletCount = 0;
+        }
+    }
+    double soaRemove = secondsSince(start);
+    std::cout << "  remove+respawn: erase(remove_if) " << aosRemove * 1e6 / removeTicks << " us/tick, slot map "
+              << soaRemove * 1e6 / removeTicks << " us/tick, " << aosRemove / soaRemove << "x ("
+              << removedSoa / removeTicks << " removed/tick, " << (removedAos == removedSoa ? "same count" : "COUNTS DIFFER") << ")" << std::endl;
+
+    for (auto& enemy : columns.cold) enemy.cleanup(textureManager, bulletPool);
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = 600;
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) ticks = std::max(1, std::atoi(argv[++i]));
+        else counts.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    if (counts.empty()) counts = { 10000, 100000 };
+    profiler.init();
+    std::cout << "Handles: " << (checkHandles() ? "stable across swap-and-pop, stale after erase/clear" : "HANDLES BROKEN") << std::endl;
+
+    // Không có renderer: TextureManager chỉ giữ handle, không giải mã ảnh
+    TextureManager textureManager;
+    textureManager.init(nullptr);
+    BulletPool bulletPool;
+    bulletPool.init(textureManager);
+    for (size_t count : counts) runBenchmark(count, ticks, textureManager, bulletPool);
+    return 0;
+}
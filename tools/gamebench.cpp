@@ -0,0 +1,369 @@
+// Micro-benchmark các đường nóng của game trên driver video dummy (không cần màn hình): đọc level,
+// dựng world, va chạm của người chơi, update từng loại kẻ địch, combat và phát lệnh vẽ.
+// Mỗi phép đo ghi ns/op với p50/p90/p99; kết quả ghi thêm ra file JSON để so giữa các lần chạy.
+// Build: g++ -std=c++17 -O2 tools/gamebench.cpp -lSDL2 -lSDL2_image -lSDL2_mixer -lSDL2_ttf -o gamebench
+// Chạy từ thư mục gốc: ./gamebench [--iterations 1000] [--level level1] [--jobs 0] [--json gamebench.json] [số kẻ địch mỗi loại ...]
+//   (mặc định 100 1000 10000; level stress sinh bằng levelgen, ví dụ --level stress10k)
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <SDL_ttf.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <sstream>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include <chrono>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "../const.h"
+#include "../mappedfile.h"
+#include "../bundle.h"
+#include "../level.h"
+#include "../atlas.h"
+#include "../open.h"
+#include "../assetloader.h"
+#include "../profiler.h"
+#include "../jobs.h"
+#include "../camera.h"
+#include "../platform.h"
+#include "../door.h"
+#include "../chunks.h"
+#include "../collision.h"
+#include "../entitystore.h"
+#include "../bullet.h"
+#include "../spatialhash.h"
+#include "../item.h"
+#include "../patrol.h"
+#include "../combat.h"
+#include "../timestep.h"
+#include "../newenemy5.h"
+#include "../enemy.h"
+#include "../newenemy4.h"
+#include "../player.h"
+#include "../boss.h"
+#include "../world.h"
+
+const float BENCH_SPACING = 60.0f;        // Khoảng cách giữa hai kẻ địch cùng loại, gần mật độ level gốc
+const int BENCH_GROUND_ROW = 8;
+
+struct BenchResult {
+    std::string name;
+    size_t count;                  // Số thực thể mỗi op; 0 nếu không áp dụng
+    std::vector<double> samples;   // ns mỗi op, đã sắp xếp
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1) + 0.5)];
+}
+
+double mean(const std::vector<double>& samples) {
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    return sum / samples.size();
+}
+
+// Chạy op một lần để làm nóng cache rồi đo từng lần; reset chạy sau mỗi op và không bị tính giờ
+template <typename Op, typename Reset>
+void measure(std::vector<BenchResult>& results, const std::string& name, size_t count, int iterations, Op op, Reset reset) {
+    op();
+    reset();
+    BenchResult result = { name, count, {} };
+    result.samples.reserve(iterations);
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        op();
+        result.samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        reset();
+    }
+    std::sort(result.samples.begin(), result.samples.end());
+    std::cout << "  " << name;
+    if (count > 0) std::cout << " (" << count << ")";
+    std::cout << ": p50 " << percentile(result.samples, 0.5) << " ns, p90 " << percentile(result.samples, 0.9)
+              << " ns, p99 " << percentile(result.samples, 0.99) << " ns";
+    if (count > 0) std::cout << ", " << percentile(result.samples, 0.5) / count << " ns/entity";
+    std::cout << std::endl;
+    results.push_back(std::move(result));
+}
+
+template <typename Op>
+void measure(std::vector<BenchResult>& results, const std::string& name, size_t count, int iterations, Op op) {
+    measure(results, name, count, iterations, op, [] {});
+}
+
+// Giống headlessInput trong main.cpp: chạy sang phải, nhảy và chém đều đặn
+void benchInput(Player& player, long long tick) {
+    if (player.isDying) return;
+    if (tick % 25 == 0) player.attack();
+    else player.moveRight();
+    if (tick % 40 == 0) player.jump();
+}
+
+void placePlayer(Player& player, const LevelData& level) {
+    levelWidthPixels = level.width * TILE_WIDTH;
+    player.x = 2 * TILE_WIDTH;
+    player.y = 2 * TILE_HEIGHT - 85;
+    player.velocityY = 0;
+    player.lives = 3;
+    player.health = player.maxHealth;
+    player.rect.x = static_cast<int>(player.x);
+    player.rect.y = static_cast<int>(player.y);
+}
+
+std::string readText(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+// Mỗi loại count con, trải đều trên mặt đất; NewEnemy5 dựng không có renderer để khỏi mở font
+// cho từng con (chữ màn hình chiến thắng không nằm trên đường nóng)
+void spawnSynthetic(EntityStore& entities, SDL_Renderer* renderer, size_t count, TextureManager& textureManager) {
+    const int types[] = { 2, 4, 5, 8 };
+    for (int type : types) {
+        for (size_t i = 0; i < count; i++) {
+            float minX = i * BENCH_SPACING;
+            float y = BENCH_GROUND_ROW * TILE_HEIGHT - 64.0f - (type == 4 || type == 8 ? 35.0f : 0.0f);
+            LevelSpawn spawn = { type, minX, minX + 3 * TILE_WIDTH, y };
+            if (type == 5) NewEnemy5::spawn(entities.newEnemies5, nullptr, spawn.minX, spawn.y, spawn.minX, spawn.maxX, textureManager);
+            else entities.spawn(renderer, spawn, textureManager);
+        }
+    }
+}
+
+void writeJson(const std::string& path, const std::vector<BenchResult>& results, const std::string& levelName,
+               int iterations, size_t jobWorkers, double timerOverhead) {
+    std::ofstream out(path);
+    out << std::fixed << std::setprecision(1);
+    out << "{\n";
+    out << "  \"benchmark\": \"gamebench\",\n";
+    out << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n";
+    out << "  \"level\": \"" << levelName << "\",\n";
+    out << "  \"iterations\": " << iterations << ",\n";
+    out << "  \"jobs\": " << jobWorkers << ",\n";
+    out << "  \"patrol_kernel\": \"" << PATROL_KERNEL_NAMES[patrolKernel] << "\",\n";
+    out << "  \"timer_overhead_ns\": " << timerOverhead << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        const std::vector<double>& samples = result.samples;
+        out << "    { \"name\": \"" << result.name << "\", \"count\": " << result.count << ", \"ops\": " << samples.size()
+            << ", \"ns_per_op\": { \"mean\": " << mean(samples) << ", \"min\": " << samples.front()
+            << ", \"p50\": " << percentile(samples, 0.5) << ", \"p90\": " << percentile(samples, 0.9)
+            << ", \"p99\": " << percentile(samples, 0.99) << ", \"max\": " << samples.back() << " }";
+        if (result.count > 0) out << ", \"ns_per_entity_p50\": " << percentile(samples, 0.5) / result.count;
+        out << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 1000;
+    int jobWorkers = 0;
+    std::string levelName = "level1";
+    std::string jsonPath = "gamebench.json";
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) iterations = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--level" && i + 1 < argc) levelName = argv[++i];
+        else if (arg == "--jobs" && i + 1 < argc) jobWorkers = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else counts.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    if (counts.empty()) counts = { 100, 1000, 10000 };
+    std::cout << std::fixed << std::setprecision(1);
+
+    // Driver dummy và renderer phần mềm: đo chi phí phát lệnh vẽ mà không phụ thuộc GPU hay cửa sổ.
+    // Biến môi trường SDL_VIDEODRIVER đặt sẵn thì được giữ nguyên.
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "❌ Khởi tạo SDL thất bại: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    profiler.init();
+    if (IMG_Init(IMG_INIT_PNG) != IMG_INIT_PNG || TTF_Init() == -1) {
+        std::cerr << "❌ Khởi tạo IMG/TTF thất bại: " << IMG_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("gamebench", 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+    SDL_Renderer* renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE) : nullptr;
+    if (!renderer) {
+        std::cerr << "❌ Tạo renderer thất bại: " << SDL_GetError() << std::endl;
+        if (window) SDL_DestroyWindow(window);
+        TTF_Quit();
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    TextureManager textureManager;
+    textureManager.init(renderer);
+    BulletPool bulletPool;
+    bulletPool.init(textureManager);
+    Player player;
+    player.init(renderer, 0, 0, textureManager);
+    JobSystem jobs;
+    jobs.init(jobWorkers);
+    std::vector<BenchResult> results;
+
+    double timerOverhead;
+    {
+        std::vector<double> empty;
+        for (int i = 0; i < 1000; i++) {
+            auto start = std::chrono::steady_clock::now();
+            empty.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(empty.begin(), empty.end());
+        timerOverhead = percentile(empty, 0.5);
+    }
+    std::cout << "Level " << levelName << ", " << iterations << " iterations, timer overhead " << timerOverhead << " ns" << std::endl;
+
+    // Hai nhánh của loadLevel: phân tích .dat và mmap .lvl đã biên dịch
+    std::string textPath = ASSETS_PATH + levelName + ".dat";
+    std::string binaryPath = ASSETS_PATH + levelName + ".lvl";
+    LevelData level;
+    struct stat info;
+    if (stat(textPath.c_str(), &info) == 0) {
+        measure(results, "loadLevel.text", 0, iterations, [&] {
+            parseLevelText(readText(textPath), level, textPath);
+        }, [&] { level.close(); });
+    }
+    if (stat(binaryPath.c_str(), &info) == 0) {
+        measure(results, "loadLevel.binary", 0, iterations, [&] {
+            if (level.file.map(binaryPath)) readLevelBinary(level.file.base, level.file.size, level, binaryPath);
+        }, [&] { level.close(); });
+    }
+    bool loaded = level.file.map(binaryPath) && readLevelBinary(level.file.base, level.file.size, level, binaryPath);
+    if (!loaded && !parseLevelText(readText(textPath), level, textPath)) {
+        std::cerr << "❌ Không tải được level " << levelName << std::endl;
+        return 1;
+    }
+
+    // initializeLevel: dựng chunk, lưới va chạm và mọi cửa, vật phẩm, kẻ địch của level
+    World world;
+    measure(results, "initializeLevel", level.doors.size() + level.items.size() + level.spawns.size(), iterations, [&] {
+        world.begin(renderer, level, textureManager);
+        world.buildSome(renderer, textureManager, world.totalToBuild());
+    }, [&] { world.cleanup(textureManager, bulletPool); });
+    world.begin(renderer, level, textureManager);
+    world.buildSome(renderer, textureManager, world.totalToBuild());
+
+    placePlayer(player, level);
+    long long tick = 0;
+    measure(results, "Player::update", 0, iterations, [&] {
+        benchInput(player, tick++);
+        player.update(world.collision);
+    }, [&] {
+        if (player.lives <= 0 || player.x >= levelWidthPixels - SCREEN_WIDTH) placePlayer(player, level);
+    });
+
+    // Vẽ level đã dựng, camera quét dần qua level; nạp chunk thuộc về update nên nằm ngoài phần đo
+    Camera camera;
+    camera.init(level.width);
+    placePlayer(player, level);
+    float maxCameraX = std::max(0.0f, static_cast<float>(camera.mapWidthPixels - SCREEN_WIDTH));
+    measure(results, "render.level", world.entities.size() + world.items.size(), iterations, [&] {
+        SDL_RenderClear(renderer);
+        world.streamer.render(camera.x);
+        for (auto& item : world.items) item.render(renderer, camera.x);
+        player.render(renderer, camera.x);
+        world.entities.render(renderer, camera.x, bulletPool);
+    }, [&] {
+        camera.x = std::fmod(camera.x + 37.0f, maxCameraX + 1.0f);
+        world.streamer.update(camera.x);
+        renderStats.lastTexture = nullptr;
+    });
+    measure(results, "SDL_RenderPresent", 0, iterations, [&] { SDL_RenderPresent(renderer); });
+    world.cleanup(textureManager, bulletPool);
+
+    for (size_t count : counts) {
+        std::cout << count << " enemies of each type" << std::endl;
+        EntityStore entities;
+        spawnSynthetic(entities, renderer, count, textureManager);
+        camera.init(static_cast<int>(count * BENCH_SPACING / TILE_WIDTH) + 4 * CHUNK_COLUMNS);
+        float playerX = count * BENCH_SPACING / 2;
+        float playerY = BENCH_GROUND_ROW * TILE_HEIGHT - 85.0f;
+        player.x = playerX;
+        player.y = playerY;
+        player.rect.x = static_cast<int>(playerX);
+        player.rect.y = static_cast<int>(playerY);
+        camera.update(playerX);
+
+        measure(results, "Enemy::update", count, iterations, [&] {
+            Enemy::update(entities.enemies, 0, entities.enemies.size(), playerX, playerY);
+        });
+        measure(results, "Enemy::updateBullets", count, iterations, [&] {
+            Enemy::updateBullets(entities.enemies, bulletPool);
+        });
+        measure(results, "NewEnemy::update", count, iterations, [&] {
+            NewEnemy::update(entities.newEnemies, 0, entities.newEnemies.size(), playerX, playerY);
+        });
+        measure(results, "NewEnemy5::update", count, iterations, [&] {
+            for (size_t i = 0; i < entities.newEnemies5.size(); i++) NewEnemy5::update(entities.newEnemies5, i);
+        });
+        measure(results, "Boss::update", count, iterations, [&] {
+            for (size_t i = 0; i < entities.bosses.size(); i++) Boss::update(entities.bosses, i, playerX, playerY, camera);
+        }, [&] { camera.update(playerX); });
+        measure(results, "EntityStore::update", entities.size(), iterations, [&] {
+            entities.update(playerX, playerY, camera, bulletPool, jobs);
+        }, [&] { camera.update(playerX); });
+
+        CombatWorld combat;
+        measure(results, "combat", entities.size(), iterations, [&] {
+            combat.clear();
+            entities.publishBullets(combat, bulletPool);
+            player.publishBoxes(combat);
+            entities.publishBoxes(combat, camera.x);
+            combat.findContacts();
+        });
+
+        measure(results, "render.entities", entities.size(), iterations, [&] {
+            SDL_RenderClear(renderer);
+            player.render(renderer, camera.x);
+            entities.render(renderer, camera.x, bulletPool);
+        }, [&] { renderStats.lastTexture = nullptr; });
+
+        entities.cleanup(textureManager, bulletPool);
+    }
+
+    writeJson(jsonPath, results, levelName, iterations, jobs.workerCount(), timerOverhead);
+    std::cout << "Wrote " << results.size() << " results to " << jsonPath << std::endl;
+
+    jobs.cleanup();
+    player.cleanup(textureManager);
+    bulletPool.cleanup(textureManager);
+    level.close();
+    textureManager.cleanup();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    TTF_Quit();
+    IMG_Quit();
+    SDL_Quit();
+    return 0;
+}
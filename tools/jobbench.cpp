@@ -0,0 +1,153 @@
+// Đo pha update kẻ địch chạy song song qua JobSystem so với chạy tuần tự, kiểm tra kết quả trùng từng bit.
+// Build: g++ -std=c++17 -O2 tools/jobbench.cpp -lSDL2 -lSDL2_image -lSDL2_mixer -lSDL2_ttf -o jobbench
+// Chạy từ thư mục gốc: ./jobbench [--ticks 500] [--workers N] [số kẻ địch ...]   (mặc định 10000 100000)
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <SDL_ttf.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <sstream>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include <chrono>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "../const.h"
+#include "../mappedfile.h"
+#include "../bundle.h"
+#include "../level.h"
+#include "../atlas.h"
+#include "../open.h"
+#include "../assetloader.h"
+#include "../profiler.h"
+#include "../jobs.h"
+#include "../camera.h"
+#include "../platform.h"
+#include "../door.h"
+#include "../chunks.h"
+#include "../collision.h"
+#include "../entitystore.h"
+#include "../bullet.h"
+#include "../spatialhash.h"
+#include "../item.h"
+#include "../patrol.h"
+#include "../combat.h"
+#include "../timestep.h"
+#include "../newenemy5.h"
+#include "../enemy.h"
+#include "../newenemy4.h"
+#include "../boss.h"
+#include "../world.h"
+
+// Cùng một cảnh chạy tuần tự (--jobs=0) và qua JobSystem; checksum phải trùng nhau
+uint64_t hashEntities(const EntityStore& entities, BulletPool& bulletPool) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; i++) {
+            hash ^= p[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    auto mixColumns = [&](const auto& columns) {
+        size_t n = columns.size();
+        mix(columns.x.data(), n * sizeof(float));
+        mix(columns.currentFrame.data(), n * sizeof(int));
+        mix(columns.frameTimer.data(), n * sizeof(int));
+        mix(columns.attackCooldown.data(), n * sizeof(int));
+        mix(columns.movingRight.data(), n);
+        mix(columns.isAttacking.data(), n);
+        mix(columns.isIdle.data(), n);
+    };
+    mixColumns(entities.enemies);
+    mixColumns(entities.newEnemies);
+    for (const auto& enemy : entities.enemies.cold) {
+        mix(&enemy.bulletCount, sizeof(int));
+        for (int k = 0; k < enemy.bulletCount; k++) {
+            const Bullet& bullet = bulletPool.get(enemy.bulletSlots[k]);
+            mix(&enemy.bulletSlots[k], sizeof(int));
+            mix(&bullet.x, sizeof(float));
+        }
+    }
+    return hash;
+}
+
+struct RunResult {
+    double seconds;
+    uint64_t hash;
+};
+
+RunResult runScene(size_t count, int ticks, int workers, TextureManager& textureManager, bool printJobs) {
+    BulletPool bulletPool;
+    bulletPool.init(textureManager);
+    Camera camera;
+    camera.init(1000000);
+    EntityStore entities;
+    seedRandom(12345);
+    for (size_t i = 0; i < count; i++) {
+        float start = static_cast<float>(nextRandom() % 200000);
+        float width = static_cast<float>(50 + nextRandom() % 400);
+        LevelSpawn spawn = { i % 2 == 0 ? 2 : 4, start, start + width, 500.0f };
+        entities.spawn(nullptr, spawn, textureManager);
+    }
+    JobSystem jobs;
+    jobs.init(workers);
+    // Người chơi chạy dọc level để kẻ địch lần lượt tấn công và bắn
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        float playerX = static_cast<float>(t) * 400.0f;
+        entities.update(playerX, 500.0f, camera, bulletPool, jobs);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t hash = hashEntities(entities, bulletPool);
+    if (printJobs) jobs.printStats();
+    jobs.cleanup();
+    entities.cleanup(textureManager, bulletPool);
+    bulletPool.cleanup(textureManager);
+    return { seconds, hash };
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = 500;
+    int workers = std::max(1, SDL_GetCPUCount() - 1);
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) ticks = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--workers" && i + 1 < argc) workers = std::max(1, std::atoi(argv[++i]));
+        else counts.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    if (counts.empty()) counts = { 10000, 100000 };
+    profiler.init();
+
+    TextureManager textureManager;
+    textureManager.init(nullptr);
+    for (size_t count : counts) {
+        std::cout << count << " enemies (Enemy + NewEnemy), " << ticks << " ticks, " << workers << " workers + main" << std::endl;
+        RunResult serial = runScene(count, ticks, 0, textureManager, false);
+        RunResult parallel = runScene(count, ticks, workers, textureManager, true);
+        std::cout << "  serial: " << serial.seconds * 1000.0 / ticks << " ms/tick, parallel: "
+                  << parallel.seconds * 1000.0 / ticks << " ms/tick, " << serial.seconds / parallel.seconds << "x, "
+                  << (serial.hash == parallel.hash ? "bit-identical" : "RESULTS DIFFER") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Biên dịch level văn bản (.dat) sang định dạng nhị phân (.lvl) mà game đọc không cần phân tích cú pháp.
+// Build: g++ -std=c++17 -O2 tools/levelc.cpp -o levelc
+// Chạy từ thư mục gốc: ./levelc [--verify] assets/level1.dat assets/level2.dat
+//   --verify: đọc lại file .lvl vừa ghi và so sánh từng ô, spawn, cửa, vật phẩm với bản văn bản
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "../const.h"
+#include "../mappedfile.h"
+#include "../level.h"
+
+bool sameLevel(const LevelData& a, const LevelData& b) {
+    if (a.width != b.width || a.height != b.height) return false;
+    for (int row = 0; row < a.height; row++) {
+        for (int col = 0; col < a.width; col++) {
+            if (a.tile(row, col) != b.tile(row, col)) return false;
+        }
+    }
+    if (a.spawns.size() != b.spawns.size() || a.doors.size() != b.doors.size() || a.items.size() != b.items.size()) return false;
+    for (size_t i = 0; i < a.spawns.size(); i++) {
+        const LevelSpawn& x = a.spawns[i];
+        const LevelSpawn& y = b.spawns[i];
+        if (x.type != y.type || x.minX != y.minX || x.maxX != y.maxX || x.y != y.y) return false;
+    }
+    for (size_t i = 0; i < a.doors.size(); i++) {
+        if (a.doors[i].x != b.doors[i].x || a.doors[i].y != b.doors[i].y) return false;
+    }
+    for (size_t i = 0; i < a.items.size(); i++) {
+        if (a.items[i].x != b.items[i].x || a.items[i].y != b.items[i].y) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool verify = false;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--verify") verify = true;
+        else inputs.push_back(arg);
+    }
+    if (inputs.empty()) {
+        std::cerr << "Cách dùng: levelc [--verify] assets/level1.dat ..." << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for (const auto& input : inputs) {
+        std::ifstream in(input);
+        if (!in.is_open()) {
+            std::cerr << "❌ Không mở được tệp: " << input << std::endl;
+            failures++;
+            continue;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+
+        LevelData level;
+        if (!parseLevelText(buffer.str(), level, input)) {
+            failures++;
+            continue;
+        }
+
+        std::string output = input.substr(0, input.rfind('.')) + ".lvl";
+        std::vector<char> bytes = writeLevelBinary(level);
+        std::ofstream out(output, std::ios::binary);
+        out.write(bytes.data(), bytes.size());
+        out.close();
+
+        int platformTiles, platformSpans;
+        countPlatformSpans(level, platformTiles, platformSpans);
+        std::cout << input << " -> " << output << ": " << level.width << "x" << level.height << ", "
+                  << level.spawns.size() << " spawns, " << level.doors.size() << " doors, "
+                  << level.items.size() << " items, " << platformTiles << " platform tiles -> " << platformSpans << " spans, "
+                  << buffer.str().size() << " -> " << bytes.size() << " bytes" << std::endl;
+
+        if (verify) {
+            LevelData reloaded;
+            std::ifstream check(output, std::ios::binary);
+            std::vector<char> written((std::istreambuf_iterator<char>(check)), std::istreambuf_iterator<char>());
+            if (!readLevelBinary(reinterpret_cast<const uint8_t*>(written.data()), written.size(), reloaded, output) ||
+                !sameLevel(level, reloaded)) {
+                std::cerr << "❌ Round-trip thất bại: " << output << std::endl;
+                failures++;
+            } else {
+                std::cout << "Round-trip OK: " << output << std::endl;
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+// Sinh level stress theo seed: rải nền tảng theo mật độ rồi đặt đúng số kẻ địch, vật phẩm và cửa yêu cầu.
+// Cùng seed và tham số luôn ra cùng một file. Ghi .dat và .lvl (đã biên dịch như levelc) cạnh nhau.
+// Build: g++ -std=c++17 -O2 tools/levelgen.cpp -o levelgen
+// Chạy từ thư mục gốc: ./levelgen [--seed 1] [--width 160] [--density 0.15] [--enemy2 N] [--enemy4 N] [--enemy5 N]
+//                                 [--enemy8 N] [--items N] [--doors 1] [--no-lvl] [assets/stress.dat]
+//   --width 0: tự chọn độ rộng vừa đủ chỗ cho số vật yêu cầu
+//   --density: tỉ lệ ô nền tảng trong dải hàng 3..(cao - 2)
+//   Ví dụ 10k kẻ địch: ./levelgen --seed 7 --width 0 --enemy2 5000 --enemy4 5000 assets/stress10k.dat
+//         1M ô:        ./levelgen --seed 7 --width 90910 --enemy2 2000 --items 2000 assets/stress1m.dat
+//   Chơi thử:          ./main --level=stress10k
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "../const.h"
+#include "../mappedfile.h"
+#include "../level.h"
+
+const int GEN_ROWS = SCREEN_HEIGHT / TILE_HEIGHT;
+const int GEN_START_COLUMNS = 8;     // Khu xuất phát của người chơi: chỉ có nền, không kẻ địch
+const int GEN_FIRST_PLATFORM_ROW = 3;
+const int GEN_MIN_RUN = 3;
+const int GEN_MAX_RUN = 10;
+
+// Mã ô kẻ địch và số ô mỗi nhóm (boss to nên cần dải dài hơn để tuần tra)
+const int GEN_ENEMY_CODES[] = { 2, 4, 5, 8 };
+const int GEN_ENEMY_WIDTHS[] = { 2, 2, 2, 4 };
+
+struct GenGrid {
+    int width = 0;
+    std::vector<uint8_t> tiles;
+
+    uint8_t& at(int row, int col) {
+        return tiles[static_cast<size_t>(row) * width + col];
+    }
+};
+
+int randomBetween(int low, int high) {
+    return low + static_cast<int>(nextRandom() % static_cast<uint32_t>(high - low + 1));
+}
+
+// Giống đoạn đầu level1: một bệ dưới chỗ người chơi xuất hiện
+void placeStartArea(GenGrid& grid) {
+    for (int col = 1; col < GEN_START_COLUMNS - 1; col++) {
+        grid.at(8, col) = 1;
+        grid.at(9, col) = 3;
+    }
+}
+
+// Rải dải nền tảng: mặt trên mã 1, bên dưới đôi khi có thân mã 3 như các cột trong level gốc
+int placePlatforms(GenGrid& grid, double density) {
+    int bandRows = GEN_ROWS - 1 - GEN_FIRST_PLATFORM_ROW;
+    long long target = static_cast<long long>(density * bandRows * (grid.width - GEN_START_COLUMNS));
+    long long placed = 0;
+    long long attempts = target * 20 + 100;
+    while (placed < target && attempts-- > 0) {
+        int row = randomBetween(GEN_FIRST_PLATFORM_ROW, GEN_ROWS - 2);
+        int length = randomBetween(GEN_MIN_RUN, GEN_MAX_RUN);
+        int start = randomBetween(GEN_START_COLUMNS, std::max(GEN_START_COLUMNS, grid.width - length));
+        int depth = nextRandom() % 3 == 0 ? randomBetween(1, 2) : 0;
+        for (int col = start; col < std::min(grid.width, start + length); col++) {
+            for (int r = row; r <= std::min(GEN_ROWS - 1, row + depth); r++) {
+                if (grid.at(r, col) != 0) continue;
+                grid.at(r, col) = r == row ? 1 : 3;
+                placed++;
+            }
+        }
+    }
+    return static_cast<int>(placed);
+}
+
+// Ô trống nằm ngay trên nền tảng, ngoài khu xuất phát
+bool isSurface(GenGrid& grid, int row, int col) {
+    return row >= 0 && row + 1 < GEN_ROWS && col >= GEN_START_COLUMNS && col < grid.width &&
+           grid.at(row, col) == 0 && isPlatformTile(grid.at(row + 1, col));
+}
+
+// Mọi ô mặt nền theo thứ tự ngẫu nhiên (theo seed). Mỗi loại vật đi qua danh sách này đúng một lần
+// bằng con trỏ riêng nên đặt N vật tốn O(số ô mặt nền), không phải thử ngẫu nhiên rồi thất bại.
+struct GenCandidate {
+    int row, col;
+};
+
+std::vector<GenCandidate> surfaceCandidates(GenGrid& grid) {
+    std::vector<GenCandidate> candidates;
+    for (int row = 0; row < GEN_ROWS; row++) {
+        for (int col = 0; col < grid.width; col++) {
+            if (isSurface(grid, row, col)) candidates.push_back({ row, col });
+        }
+    }
+    for (size_t i = candidates.size(); i > 1; i--) std::swap(candidates[i - 1], candidates[nextRandom() % i]);
+    return candidates;
+}
+
+// Một nhóm kẻ địch: width ô liền nhau trên cùng một mặt nền, hai bên không dính kẻ địch khác để
+// resolveLevel không gộp hai nhóm làm một
+bool placeEnemy(GenGrid& grid, const std::vector<GenCandidate>& candidates, size_t& cursor, int code, int width) {
+    while (cursor < candidates.size()) {
+        int row = candidates[cursor].row;
+        int col = candidates[cursor++].col;
+        if (col + width > grid.width) continue;
+        bool fits = true;
+        for (int c = col; c < col + width && fits; c++) fits = isSurface(grid, row, c);
+        if (!fits) continue;
+        if (col > 0 && isEnemyTile(grid.at(row, col - 1))) continue;
+        if (col + width < grid.width && isEnemyTile(grid.at(row, col + width))) continue;
+        for (int c = col; c < col + width; c++) grid.at(row, c) = static_cast<uint8_t>(code);
+        return true;
+    }
+    return false;
+}
+
+// Vật phẩm nằm trên mặt nền hoặc lơ lửng cao hơn một ô như trong level gốc
+bool placeItem(GenGrid& grid, const std::vector<GenCandidate>& candidates, size_t& cursor) {
+    while (cursor < candidates.size()) {
+        int row = candidates[cursor].row;
+        int col = candidates[cursor++].col;
+        if (!isSurface(grid, row, col)) continue;
+        if (row > 0 && grid.at(row - 1, col) == 0 && nextRandom() % 2 == 0) row--;
+        grid.at(row, col) = 7;
+        return true;
+    }
+    return false;
+}
+
+// Cửa đầu tiên ở cuối level như level gốc, các cửa sau trải đều về phía đầu
+bool placeDoor(GenGrid& grid, int index, int count) {
+    int span = grid.width - GEN_START_COLUMNS;
+    int target = grid.width - 1 - static_cast<int>(static_cast<long long>(span) * index / count);
+    for (int col = target; col >= GEN_START_COLUMNS; col--) {
+        for (int row = GEN_FIRST_PLATFORM_ROW - 1; row < GEN_ROWS - 1; row++) {
+            if (!isSurface(grid, row, col)) continue;
+            grid.at(row, col) = 6;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Đủ rộng để mặt nền (ước theo mật độ, khoảng một nửa ô nền tảng là mặt trên) chứa gấp rưỡi số ô cần dùng
+int autoWidth(const int enemyCounts[4], int items, int doors, double density) {
+    long long needed = items + doors;
+    for (int i = 0; i < 4; i++) needed += static_cast<long long>(enemyCounts[i]) * (GEN_ENEMY_WIDTHS[i] + 1);
+    double surfacePerColumn = std::max(0.01, density * (GEN_ROWS - 1 - GEN_FIRST_PLATFORM_ROW) / 2.0);
+    long long columns = static_cast<long long>(needed * 1.5 / surfacePerColumn);
+    return static_cast<int>(std::max<long long>(2 * CHUNK_COLUMNS, GEN_START_COLUMNS + columns));
+}
+
+// Cùng kiểu với level1.dat: số cách nhau một dấu cách, thêm một dấu cách sau mỗi 20 cột
+std::string formatLevelText(GenGrid& grid) {
+    std::string text;
+    text.reserve(static_cast<size_t>(GEN_ROWS) * grid.width * 2 + GEN_ROWS * (grid.width / 20 + 1));
+    for (int row = 0; row < GEN_ROWS; row++) {
+        for (int col = 0; col < grid.width; col++) {
+            if (col > 0) text += col % 20 == 0 ? "  " : " ";
+            text += static_cast<char>('0' + grid.at(row, col));
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = 1;
+    int width = 160;
+    double density = 0.15;
+    int enemyCounts[4] = { 0, 0, 0, 0 };
+    int items = 0;
+    int doors = 1;
+    bool writeBinary = true;
+    std::string output = ASSETS_PATH + "stress.dat";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--width" && hasValue) width = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--density" && hasValue) density = std::min(0.9, std::max(0.0, std::atof(argv[++i])));
+        else if (arg == "--enemy2" && hasValue) enemyCounts[0] = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--enemy4" && hasValue) enemyCounts[1] = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--enemy5" && hasValue) enemyCounts[2] = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--enemy8" && hasValue) enemyCounts[3] = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--items" && hasValue) items = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--doors" && hasValue) doors = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--no-lvl") writeBinary = false;
+        else output = arg;
+    }
+    if (width == 0) width = autoWidth(enemyCounts, items, doors, density);
+    if (width < GEN_START_COLUMNS + GEN_MAX_RUN) {
+        std::cerr << "❌ Level quá hẹp: cần ít nhất " << GEN_START_COLUMNS + GEN_MAX_RUN << " cột" << std::endl;
+        return 1;
+    }
+
+    seedRandom(seed);
+    GenGrid grid;
+    grid.width = width;
+    grid.tiles.assign(static_cast<size_t>(GEN_ROWS) * width, 0);
+    placeStartArea(grid);
+    placePlatforms(grid, density);
+
+    // Cửa đặt trước để luôn nằm ở cuối level; boss đặt trước kẻ địch nhỏ vì cần dải dài
+    bool ok = true;
+    for (int i = 0; i < doors && ok; i++) ok = placeDoor(grid, i, doors);
+    std::vector<GenCandidate> candidates = surfaceCandidates(grid);
+    for (int type = 3; type >= 0 && ok; type--) {
+        size_t cursor = 0;
+        for (int i = 0; i < enemyCounts[type] && ok; i++) {
+            ok = placeEnemy(grid, candidates, cursor, GEN_ENEMY_CODES[type], GEN_ENEMY_WIDTHS[type]);
+        }
+    }
+    size_t itemCursor = 0;
+    for (int i = 0; i < items && ok; i++) ok = placeItem(grid, candidates, itemCursor);
+    if (!ok) {
+        std::cerr << "❌ Không đủ chỗ trên nền tảng, hãy tăng --width hoặc --density (hoặc dùng --width 0)" << std::endl;
+        return 1;
+    }
+
+    std::string text = formatLevelText(grid);
+    LevelData level;
+    if (!parseLevelText(text, level, output)) return 1;
+    int spawnCounts[4] = { 0, 0, 0, 0 };
+    for (const auto& spawn : level.spawns) {
+        for (int type = 0; type < 4; type++) {
+            if (spawn.type == GEN_ENEMY_CODES[type]) spawnCounts[type]++;
+        }
+    }
+    if (!std::equal(spawnCounts, spawnCounts + 4, enemyCounts) || static_cast<int>(level.items.size()) != items ||
+        static_cast<int>(level.doors.size()) != doors) {
+        std::cerr << "❌ Số vật sau khi đọc lại không khớp yêu cầu" << std::endl;
+        return 1;
+    }
+
+    std::ofstream textFile(output, std::ios::binary);
+    textFile.write(text.data(), text.size());
+    textFile.close();
+    if (!textFile) {
+        std::cerr << "❌ Không ghi được tệp: " << output << std::endl;
+        return 1;
+    }
+    std::string binaryPath;
+    if (writeBinary) {
+        // Ghi sau .dat để .lvl không bị loadLevel coi là cũ hơn
+        binaryPath = output.substr(0, output.rfind('.')) + ".lvl";
+        std::vector<char> bytes = writeLevelBinary(level);
+        std::ofstream binaryFile(binaryPath, std::ios::binary);
+        binaryFile.write(bytes.data(), bytes.size());
+        binaryFile.close();
+        if (!binaryFile) {
+            std::cerr << "❌ Không ghi được tệp: " << binaryPath << std::endl;
+            return 1;
+        }
+    }
+
+    int platformTiles, platformSpans;
+    countPlatformSpans(level, platformTiles, platformSpans);
+    std::cout << output << (writeBinary ? ", " + binaryPath : "") << ": seed " << seed << ", " << level.width << "x"
+              << level.height << " (" << static_cast<long long>(level.width) * level.height << " tiles), "
+              << platformTiles << " platform tiles -> " << platformSpans << " spans" << std::endl;
+    std::cout << "  spawns: " << level.spawns.size() << " (2: " << spawnCounts[0] << ", 4: " << spawnCounts[1]
+              << ", 5: " << spawnCounts[2] << ", 8: " << spawnCounts[3] << "), " << level.items.size() << " items, "
+              << level.doors.size() << " doors" << std::endl;
+    return 0;
+}
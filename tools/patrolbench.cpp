@@ -0,0 +1,92 @@
+// Đo patrolStep: bản vô hướng so với SSE2/AVX2 trên cùng dữ liệu, kiểm tra kết quả trùng từng byte.
+// Build: g++ -std=c++17 -O2 tools/patrolbench.cpp -o patrolbench
+// Chạy từ thư mục gốc: ./patrolbench [--ticks 200] [số hàng ...]   (mặc định 1000 10000 100000 1000000)
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#include "../entitystore.h"
+#include "../patrol.h"
+
+struct NoCold {};
+
+uint32_t benchState = 12345;
+
+uint32_t benchRandom() {
+    benchState = benchState * 1664525u + 1013904223u;
+    return benchState >> 8;
+}
+
+// Trộn hàng đang tuần tra với hàng đang đánh/bị đánh, vài hàng có currentFrame ngoài khoảng để
+// đi qua nhánh dự phòng vô hướng
+void fillColumns(EntityColumns<NoCold>& columns, size_t count) {
+    benchState = 12345;
+    columns.clear();
+    for (size_t i = 0; i < count; i++) {
+        float start = static_cast<float>(benchRandom() % 2000000);
+        float speed = 0.5f + static_cast<float>(benchRandom() % 1000) / 400.0f;
+        size_t row = columns.add(start + static_cast<float>(benchRandom() % 50), 500.0f, start, start + 50 + benchRandom() % 400, speed);
+        columns.movingRight[row] = benchRandom() % 2;
+        columns.frameTimer[row] = benchRandom() % 8;
+        columns.currentFrame[row] = benchRandom() % 1000 == 0 ? 37 : static_cast<int>(benchRandom() % 4);
+        columns.patrol[row] = benchRandom() % 10 != 0;
+    }
+}
+
+bool sameColumns(const EntityColumns<NoCold>& a, const EntityColumns<NoCold>& b) {
+    size_t n = a.size();
+    return std::memcmp(a.x.data(), b.x.data(), n * sizeof(float)) == 0 &&
+           std::memcmp(a.movingRight.data(), b.movingRight.data(), n) == 0 &&
+           std::memcmp(a.frameTimer.data(), b.frameTimer.data(), n * sizeof(int)) == 0 &&
+           std::memcmp(a.currentFrame.data(), b.currentFrame.data(), n * sizeof(int)) == 0;
+}
+
+double runKernel(EntityColumns<NoCold>& columns, int ticks) {
+    PatrolArrays arrays = patrolArrays(columns);
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) patrolStep(arrays, 0, columns.size(), 8, 4);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = 200;
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) ticks = std::max(1, std::atoi(argv[++i]));
+        else counts.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    if (counts.empty()) counts = { 1000, 10000, 100000, 1000000 };
+
+    PatrolKernel best = detectPatrolKernel();
+    std::cout << "Best kernel on this CPU: " << PATROL_KERNEL_NAMES[best] << std::endl;
+    for (size_t count : counts) {
+        // Lặp lại số tick sao cho mỗi cỡ chạy chừng ấy lượt hàng, để cỡ nhỏ cũng đo được
+        int runTicks = static_cast<int>(std::max<size_t>(ticks, ticks * 100000 / std::max<size_t>(count, 1)));
+        EntityColumns<NoCold> reference;
+        fillColumns(reference, count);
+        selectPatrolKernel("scalar");
+        double scalarTime = runKernel(reference, runTicks);
+        double updates = static_cast<double>(count) * runTicks;
+        std::cout << count << " rows, " << runTicks << " ticks" << std::endl;
+        std::cout << "  scalar: " << scalarTime * 1e9 / updates << " ns/row" << std::endl;
+
+        for (int kernel = PATROL_KERNEL_SSE2; kernel <= best; kernel++) {
+            EntityColumns<NoCold> columns;
+            fillColumns(columns, count);
+            selectPatrolKernel(PATROL_KERNEL_NAMES[kernel]);
+            double time = runKernel(columns, runTicks);
+            std::cout << "  " << PATROL_KERNEL_NAMES[kernel] << ": " << time * 1e9 / updates << " ns/row, "
+                      << scalarTime / time << "x, " << (sameColumns(reference, columns) ? "bit-identical" : "RESULTS DIFFER")
+                      << std::endl;
+        }
+    }
+    return 0;
+}
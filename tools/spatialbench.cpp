@@ -0,0 +1,167 @@
+// Đo SpatialHash so với duyệt toàn bộ: cập nhật tăng dần mỗi tick rồi truy vấn bán kính và hình chữ nhật.
+// Build: g++ -std=c++17 -O2 tools/spatialbench.cpp -o spatialbench
+// Chạy từ thư mục gốc: ./spatialbench [--ticks 20] [--queries 200] [số vật ...]   (mặc định 1000 10000 100000)
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include "../spatialhash.h"
+
+const float BENCH_LEVEL_HEIGHT = 768.0f;
+const float BENCH_WIDTH_PER_OBJECT = 40.0f;   // Level dài ra theo số vật để mật độ giữ nguyên
+const float BENCH_QUERY_RADIUS = 200.0f;
+const float BENCH_QUERY_SIZE = 300.0f;
+
+uint32_t benchState = 12345;
+
+uint32_t benchRandom() {
+    benchState = benchState * 1664525u + 1013904223u;
+    return benchState >> 8;
+}
+
+float benchUniform(float range) {
+    return static_cast<float>(benchRandom() % 1000000) / 1000000.0f * range;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Vật tuần tra như kẻ địch trong game: đi qua lại giữa minX và maxX
+struct BenchObject {
+    SpatialBox box;
+    float speed;
+    float minX, maxX;
+    uint32_t id;
+};
+
+void moveObjects(std::vector<BenchObject>& objects) {
+    for (auto& object : objects) {
+        object.box.x += object.speed;
+        if (object.box.x >= object.maxX || object.box.x <= object.minX) object.speed = -object.speed;
+    }
+}
+
+bool circleHits(const SpatialBox& box, float x, float y, float radius) {
+    float nearestX = std::max(box.x, std::min(x, box.x + box.w));
+    float nearestY = std::max(box.y, std::min(y, box.y + box.h));
+    float dx = x - nearestX;
+    float dy = y - nearestY;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+void runBenchmark(size_t count, int ticks, int queries) {
+    benchState = 12345;
+    float levelWidth = count * BENCH_WIDTH_PER_OBJECT;
+    std::vector<BenchObject> objects(count);
+    for (auto& object : objects) {
+        // Phần lớn cỡ kẻ địch/đạn, vài vật cỡ boss
+        float w = benchRandom() % 100 == 0 ? 432.0f : 36.0f + benchUniform(28.0f);
+        float h = w > 400 ? 177.0f : 18.0f + benchUniform(46.0f);
+        object.minX = benchUniform(levelWidth);
+        object.maxX = object.minX + 50 + benchUniform(400);
+        object.box = { object.minX, benchUniform(BENCH_LEVEL_HEIGHT - h), w, h };
+        object.speed = 0.5f + benchUniform(3.0f);
+    }
+    std::vector<SpatialBox> areas(queries);
+    std::vector<float> centerX(queries), centerY(queries);
+
+    SpatialHash spatial;
+    spatial.init();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) objects[i].id = spatial.insert(SPATIAL_ENEMY, static_cast<uint32_t>(i), objects[i].box);
+    double insertTime = secondsSince(start);
+
+    double moveTime = 0, updateTime = 0;
+    double gridRect = 0, bruteRect = 0, gridRadius = 0, bruteRadius = 0;
+    size_t gridRectHits = 0, bruteRectHits = 0, gridRadiusHits = 0, bruteRadiusHits = 0;
+    long long cellChangesBefore = spatial.cellChanges;
+    std::vector<SpatialHit> hits;
+    for (int t = 0; t < ticks; t++) {
+        start = std::chrono::steady_clock::now();
+        moveObjects(objects);
+        moveTime += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; i++) spatial.update(objects[i].id, static_cast<uint32_t>(i), objects[i].box);
+        updateTime += secondsSince(start);
+
+        for (int q = 0; q < queries; q++) {
+            centerX[q] = benchUniform(levelWidth);
+            centerY[q] = benchUniform(BENCH_LEVEL_HEIGHT);
+            areas[q] = { centerX[q] - BENCH_QUERY_SIZE / 2, centerY[q] - BENCH_QUERY_SIZE / 2, BENCH_QUERY_SIZE, BENCH_QUERY_SIZE };
+        }
+
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            hits.clear();
+            spatial.queryRect(areas[q], hits);
+            gridRectHits += hits.size();
+        }
+        gridRect += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            for (const auto& object : objects) {
+                if (spatialOverlap(object.box, areas[q])) bruteRectHits++;
+            }
+        }
+        bruteRect += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            hits.clear();
+            spatial.queryRadius(centerX[q], centerY[q], BENCH_QUERY_RADIUS, hits);
+            gridRadiusHits += hits.size();
+        }
+        gridRadius += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            for (const auto& object : objects) {
+                if (circleHits(object.box, centerX[q], centerY[q], BENCH_QUERY_RADIUS)) bruteRadiusHits++;
+            }
+        }
+        bruteRadius += secondsSince(start);
+    }
+
+    double totalQueries = static_cast<double>(queries) * ticks;
+    double totalUpdates = static_cast<double>(count) * ticks;
+    std::cout << count << " objects, " << ticks << " ticks, " << queries << " queries/tick ("
+              << spatial.buckets.size() << " buckets, cell " << spatial.cellSize << " px)" << std::endl;
+    std::cout << "  insert: " << insertTime * 1e9 / count << " ns/object" << std::endl;
+    std::cout << "  update: " << updateTime * 1e9 / totalUpdates << " ns/object ("
+              << 100.0 * (spatial.cellChanges - cellChangesBefore) / totalUpdates << "% changed cell, move itself "
+              << moveTime * 1e9 / totalUpdates << " ns/object)" << std::endl;
+    std::cout << "  rect   grid " << gridRect * 1e9 / totalQueries << " ns/query, brute force "
+              << bruteRect * 1e9 / totalQueries << " ns/query, " << bruteRect / gridRect << "x" << std::endl;
+    std::cout << "  radius grid " << gridRadius * 1e9 / totalQueries << " ns/query, brute force "
+              << bruteRadius * 1e9 / totalQueries << " ns/query, " << bruteRadius / gridRadius << "x" << std::endl;
+    // Hòa vốn: số truy vấn mỗi tick để chi phí cập nhật lưới được bù lại so với duyệt toàn bộ
+    double savedPerQuery = (bruteRect - gridRect) / totalQueries;
+    if (savedPerQuery > 0) {
+        std::cout << "  break-even: " << (updateTime / ticks) / savedPerQuery << " rect queries/tick" << std::endl;
+    }
+    std::cout << "  " << static_cast<double>(gridRectHits) / totalQueries << " hits/query, "
+              << (gridRectHits == bruteRectHits && gridRadiusHits == bruteRadiusHits ? "results identical" : "RESULTS DIFFER")
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = 20;
+    int queries = 200;
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) ticks = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--queries" && i + 1 < argc) queries = std::max(1, std::atoi(argv[++i]));
+        else counts.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    if (counts.empty()) counts = { 1000, 10000, 100000 };
+    for (size_t count : counts) runBenchmark(count, ticks, queries);
+    return 0;
+}
@@ -0,0 +1,330 @@
+const int WORLD_BUILD_PER_FRAME = 8;                // Số thực thể dựng mỗi frame khi chuẩn bị level sau
+const float PREFETCH_DOOR_DISTANCE = 2 * SCREEN_WIDTH;  // Bắt đầu chuẩn bị level sau khi người chơi cách cửa chừng này
+
+// Danh sách sheet mà level cần, để giải mã trước trên luồng phụ
+void collectLevelAssets(const LevelData& level, std::vector<std::string>& paths) {
+    bool seen[10] = {};
+    for (const auto& spawn : level.spawns) {
+        if (spawn.type >= 0 && spawn.type < 10) seen[spawn.type] = true;
+    }
+    seen[7] = !level.items.empty();
+    if (seen[2]) Enemy::listAssets(paths);
+    if (seen[4]) NewEnemy::listAssets(paths);
+    if (seen[5]) NewEnemy5::listAssets(paths);
+    if (seen[7]) Item::listAssets(paths);
+    if (seen[8]) Boss::listAssets(paths);
+}
+
+template <typename Cold>
+SpatialBox spatialBoxOf(const EntityColumns<Cold>& columns, size_t i) {
+    return { columns.x[i], columns.y[i], 64, 64 };
+}
+
+SpatialBox spatialBoxOf(const EntityColumns<Boss>& columns, size_t i) {
+    float scale = columns.cold[i].scale;
+    return { columns.x[i], columns.y[i], 288 * scale, 118 * scale };
+}
+
+// Hàng mới được chèn, hàng cũ chỉ ghi lại hộp và chỉ số (removeMarked có thể đã dồn hàng)
+template <typename Cold>
+void trackColumns(SpatialHash& spatial, EntityColumns<Cold>& columns, SpatialKind kind) {
+    for (size_t i = 0; i < columns.size(); i++) {
+        uint32_t& id = columns.spatialId[i];
+        SpatialBox box = spatialBoxOf(columns, i);
+        if (id == SPATIAL_NONE) id = spatial.insert(kind, static_cast<uint32_t>(i), box);
+        else spatial.update(id, static_cast<uint32_t>(i), box);
+    }
+}
+
+// Bốn loại kẻ địch của một level, mỗi loại một bảng cột. Thứ tự update/vẽ giữ như cũ:
+// Enemy, NewEnemy, NewEnemy5, Boss.
+struct EntityStore {
+    EntityColumns<Enemy> enemies;
+    EntityColumns<NewEnemy> newEnemies;
+    EntityColumns<NewEnemy5> newEnemies5;
+    EntityColumns<Boss> bosses;
+
+    size_t size() const {
+        return enemies.size() + newEnemies.size() + newEnemies5.size() + bosses.size();
+    }
+
+    void spawn(SDL_Renderer* renderer, const LevelSpawn& spawn, TextureManager& textureManager) {
+        if (spawn.type == 2) Enemy::spawn(enemies, spawn.minX, spawn.y, spawn.minX, spawn.maxX, textureManager);
+        else if (spawn.type == 4) NewEnemy::spawn(newEnemies, spawn.minX, spawn.y, spawn.minX, spawn.maxX, textureManager);
+        else if (spawn.type == 5) NewEnemy5::spawn(newEnemies5, renderer, spawn.minX, spawn.y, spawn.minX, spawn.maxX, textureManager);
+        else if (spawn.type == 8) Boss::spawn(bosses, spawn.minX, spawn.y, spawn.minX, spawn.maxX, textureManager);
+    }
+
+    void storePrevious(BulletPool& bulletPool) {
+        enemies.storePrevious();
+        for (const auto& enemy : enemies.cold) {
+            for (int k = 0; k < enemy.bulletCount; k++) ::storePrevious(bulletPool.get(enemy.bulletSlots[k]));
+        }
+        newEnemies.storePrevious();
+        newEnemies5.storePrevious();
+        bosses.storePrevious();
+    }
+
+    // Enemy và NewEnemy chỉ đọc vị trí người chơi và hàng của mình nên chạy song song theo đoạn;
+    // đạn, NewEnemy5 (dùng chung bộ sinh số ngẫu nhiên) và boss (rung camera) vẫn chạy tuần tự
+    void update(float playerX, float playerY, Camera& camera, BulletPool& bulletPool, JobSystem& jobs) {
+        jobs.parallelFor(enemies.size(), JOB_MIN_GRAIN, [&](size_t begin, size_t end) {
+            Enemy::update(enemies, begin, end, playerX, playerY);
+        });
+        jobs.parallelFor(newEnemies.size(), JOB_MIN_GRAIN, [&](size_t begin, size_t end) {
+            NewEnemy::update(newEnemies, begin, end, playerX, playerY);
+        });
+        Enemy::updateBullets(enemies, bulletPool);
+        // Đạn còn bay được đẩy thêm một bước nữa; tốc độ đạn trong game đã quen với hai bước mỗi tick
+        for (const auto& enemy : enemies.cold) {
+            for (int k = 0; k < enemy.bulletCount; k++) bulletPool.get(enemy.bulletSlots[k]).update();
+        }
+        {
+            PROFILE_SCOPE("NewEnemy5::update");
+            for (size_t i = 0; i < newEnemies5.size(); i++) NewEnemy5::update(newEnemies5, i);
+        }
+        {
+            PROFILE_SCOPE("Boss::update");
+            for (size_t i = 0; i < bosses.size(); i++) Boss::update(bosses, i, playerX, playerY, camera);
+        }
+    }
+
+    // Mỗi loại một scope thay vì mỗi con một scope, để vòng đệm của profiler không bị lấp đầy
+    void render(SDL_Renderer* renderer, float cameraX, BulletPool& bulletPool) {
+        {
+            PROFILE_SCOPE("Enemy::render");
+            for (size_t i = 0; i < enemies.size(); i++) Enemy::render(enemies, i, renderer, cameraX);
+        }
+        {
+            PROFILE_SCOPE("NewEnemy::render");
+            for (size_t i = 0; i < newEnemies.size(); i++) NewEnemy::render(newEnemies, i, renderer, cameraX);
+        }
+        {
+            PROFILE_SCOPE("NewEnemy5::render");
+            for (size_t i = 0; i < newEnemies5.size(); i++) NewEnemy5::render(newEnemies5, i, renderer, cameraX);
+        }
+        {
+            PROFILE_SCOPE("Boss::render");
+            for (size_t i = 0; i < bosses.size(); i++) Boss::render(bosses, i, renderer, cameraX);
+        }
+        PROFILE_SCOPE("Bullet::render");
+        for (const auto& enemy : enemies.cold) {
+            for (int k = 0; k < enemy.bulletCount; k++) {
+                bulletPool.get(enemy.bulletSlots[k]).render(renderer, cameraX);
+            }
+        }
+    }
+
+    void publishBullets(CombatWorld& combat, BulletPool& bulletPool) const {
+        for (const auto& enemy : enemies.cold) {
+            for (int k = 0; k < enemy.bulletCount; k++) {
+                const Bullet& bullet = bulletPool.get(enemy.bulletSlots[k]);
+                SDL_Rect rect = { static_cast<int>(bullet.x), static_cast<int>(bullet.y), bullet.width, bullet.height };
+                combat.addHitbox(rect, FACTION_ENEMY, BULLET_DAMAGE, OWNER_BULLET, enemy.bulletSlots[k]);
+            }
+        }
+    }
+
+    void publishBoxes(CombatWorld& combat, float cameraX) const {
+        Enemy::publishBoxes(enemies, combat, cameraX);
+        NewEnemy::publishBoxes(newEnemies, combat, cameraX);
+        NewEnemy5::publishBoxes(newEnemies5, combat, cameraX);
+        Boss::publishBoxes(bosses, combat, cameraX);
+    }
+
+    int endScreenIndex() const {
+        for (size_t i = 0; i < newEnemies5.size(); i++) {
+            if (newEnemies5.cold[i].isEndScreen) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    size_t removeMarked(TextureManager& textureManager, BulletPool& bulletPool, SpatialHash& spatial) {
+        return enemies.removeMarked([&](size_t i) {
+                   spatial.remove(enemies.spatialId[i]);
+                   enemies.cold[i].cleanup(textureManager, bulletPool);
+               }) +
+               newEnemies.removeMarked([&](size_t i) {
+                   spatial.remove(newEnemies.spatialId[i]);
+                   newEnemies.cold[i].cleanup(textureManager);
+               }) +
+               newEnemies5.removeMarked([&](size_t i) {
+                   spatial.remove(newEnemies5.spatialId[i]);
+                   newEnemies5.cold[i].cleanup(textureManager);
+               }) +
+               bosses.removeMarked([&](size_t i) {
+                   spatial.remove(bosses.spatialId[i]);
+                   bosses.cold[i].cleanup(textureManager);
+               });
+    }
+
+    void cleanup(TextureManager& textureManager, BulletPool& bulletPool) {
+        for (auto& enemy : enemies.cold) enemy.cleanup(textureManager, bulletPool);
+        enemies.clear();
+        for (auto& newEnemy : newEnemies.cold) newEnemy.cleanup(textureManager);
+        newEnemies.clear();
+        for (auto& newEnemy5 : newEnemies5.cold) newEnemy5.cleanup(textureManager);
+        newEnemies5.clear();
+        for (auto& boss : bosses.cold) boss.cleanup(textureManager);
+        bosses.clear();
+    }
+};
+
+// Toàn bộ trạng thái của một level đang chơi; đổi level chỉ là std::swap hai World
+struct World {
+    const LevelData* level = nullptr;
+    ChunkStreamer streamer;
+    CollisionGrid collision;
+    EntityStore entities;
+    std::vector<Door> doors;
+    std::vector<Item> items;
+    SpatialHash spatial;   // Kẻ địch, boss, vật phẩm chưa nhặt và đạn; cập nhật sau bước update mỗi tick
+    uint32_t bulletSpatialIds[BULLET_POOL_CAPACITY] = {};
+    size_t built = 0;   // Số cửa + vật phẩm + spawn đã dựng
+
+    void begin(SDL_Renderer* renderer, const LevelData& level, TextureManager& textureManager) {
+        this->level = &level;
+        built = 0;
+        streamer.init(renderer, level, textureManager);
+        streamer.update(0);
+        collision.init(level);
+    }
+
+    size_t totalToBuild() const {
+        return level->doors.size() + level->items.size() + level->spawns.size();
+    }
+
+    bool isBuilt() const {
+        return level && built >= totalToBuild();
+    }
+
+    // Dựng tối đa budget thực thể; texture phải có sẵn trong cache để việc này không chạm tới đĩa
+    bool buildSome(SDL_Renderer* renderer, TextureManager& textureManager, size_t budget) {
+        size_t doorCount = level->doors.size();
+        size_t itemCount = level->items.size();
+        for (size_t done = 0; done < budget && !isBuilt(); done++, built++) {
+            if (built < doorCount) {
+                const LevelPoint& point = level->doors[built];
+                Door door;
+                door.init(renderer, point.x, point.y, textureManager);
+                doors.push_back(door);
+            } else if (built < doorCount + itemCount) {
+                const LevelPoint& point = level->items[built - doorCount];
+                Item item;
+                item.init(renderer, point.x, point.y, textureManager);
+                items.push_back(item);
+            } else {
+                entities.spawn(renderer, level->spawns[built - doorCount - itemCount], textureManager);
+            }
+        }
+        return isBuilt();
+    }
+
+    // Chỉ số trong lưới đúng từ lúc này tới removeMarked cuối tick
+    void updateSpatial(BulletPool& bulletPool) {
+        PROFILE_SCOPE("World::updateSpatial");
+        trackColumns(spatial, entities.enemies, SPATIAL_ENEMY);
+        trackColumns(spatial, entities.newEnemies, SPATIAL_NEW_ENEMY);
+        trackColumns(spatial, entities.newEnemies5, SPATIAL_NEW_ENEMY5);
+        trackColumns(spatial, entities.bosses, SPATIAL_BOSS);
+        // Vật phẩm đứng yên: chỉ chèn lần đầu; nhặt xong thì main bỏ khỏi lưới
+        for (size_t i = 0; i < items.size(); i++) {
+            Item& item = items[i];
+            if (item.isCollected || item.spatialId != SPATIAL_NONE) continue;
+            SpatialBox box = { static_cast<float>(item.rect.x), static_cast<float>(item.rect.y),
+                               static_cast<float>(item.rect.w), static_cast<float>(item.rect.h) };
+            item.spatialId = spatial.insert(SPATIAL_ITEM, static_cast<uint32_t>(i), box);
+        }
+        // Đạn theo slot của pool; slot không còn thuộc kẻ địch nào là đạn đã bị trả về
+        bool live[BULLET_POOL_CAPACITY] = {};
+        for (const auto& enemy : entities.enemies.cold) {
+            for (int k = 0; k < enemy.bulletCount; k++) {
+                int slot = enemy.bulletSlots[k];
+                const Bullet& bullet = bulletPool.get(slot);
+                SpatialBox box = { bullet.x, bullet.y, static_cast<float>(bullet.width), static_cast<float>(bullet.height) };
+                uint32_t& id = bulletSpatialIds[slot];
+                if (id == SPATIAL_NONE) id = spatial.insert(SPATIAL_BULLET, static_cast<uint32_t>(slot), box);
+                else spatial.update(id, static_cast<uint32_t>(slot), box);
+                live[slot] = true;
+            }
+        }
+        for (int slot = 0; slot < BULLET_POOL_CAPACITY; slot++) {
+            if (live[slot] || bulletSpatialIds[slot] == SPATIAL_NONE) continue;
+            spatial.remove(bulletSpatialIds[slot]);
+            bulletSpatialIds[slot] = SPATIAL_NONE;
+        }
+    }
+
+    // Sau hot reload: hàng và vật phẩm bị xóa giữa chừng nên dựng lại cả lưới
+    void rebuildSpatial(BulletPool& bulletPool) {
+        spatial.clear();
+        entities.enemies.spatialId.assign(entities.enemies.size(), SPATIAL_NONE);
+        entities.newEnemies.spatialId.assign(entities.newEnemies.size(), SPATIAL_NONE);
+        entities.newEnemies5.spatialId.assign(entities.newEnemies5.size(), SPATIAL_NONE);
+        entities.bosses.spatialId.assign(entities.bosses.size(), SPATIAL_NONE);
+        for (auto& item : items) item.spatialId = SPATIAL_NONE;
+        for (auto& id : bulletSpatialIds) id = SPATIAL_NONE;
+        updateSpatial(bulletPool);
+    }
+
+    void cleanup(TextureManager& textureManager, BulletPool& bulletPool) {
+        spatial.clear();
+        for (auto& id : bulletSpatialIds) id = SPATIAL_NONE;
+        entities.cleanup(textureManager, bulletPool);
+        for (auto& door : doors) door.cleanup();
+        doors.clear();
+        for (auto& item : items) item.cleanup(textureManager);
+        items.clear();
+        streamer.cleanup();
+        level = nullptr;
+        built = 0;
+    }
+};
+
+// Chuẩn bị level sau trong lúc level hiện tại vẫn đang chơi: giải mã texture trên luồng phụ,
+// rồi dựng thực thể vài cái mỗi frame. Khi màn hình chuyển đen chỉ còn việc đổi hai World.
+struct LevelPrefetcher {
+    World world;
+    const LevelData* pending = nullptr;   // Level đang được chuẩn bị, world.level chỉ được gán khi bắt đầu dựng
+    int targetLevel = 0;
+    int framesBuilding = 0;
+
+    void start(int target, const LevelData& level, AssetLoader& assetLoader, TextureManager& textureManager) {
+        if (targetLevel == target) return;
+        targetLevel = target;
+        pending = &level;
+        framesBuilding = 0;
+        std::vector<std::string> paths;
+        collectLevelAssets(level, paths);
+        assetLoader.requestAll(paths, textureManager);
+    }
+
+    bool isReady() const {
+        return world.isBuilt();
+    }
+
+    // Gọi mỗi frame sau AssetLoader::pump; chỉ dựng thực thể khi mọi texture đã lên GPU
+    void update(SDL_Renderer* renderer, AssetLoader& assetLoader, TextureManager& textureManager) {
+        if (!pending || world.isBuilt() || !assetLoader.isIdle()) return;
+        if (!world.level) world.begin(renderer, *pending, textureManager);
+        framesBuilding++;
+        if (world.buildSome(renderer, textureManager, WORLD_BUILD_PER_FRAME)) {
+            std::cout << "Prefetch: level " << targetLevel << " ready (" << world.totalToBuild()
+                      << " entities over " << framesBuilding << " frames)" << std::endl;
+        }
+    }
+
+    // Người chơi tới cửa trước khi chuẩn bị xong: làm nốt phần còn lại ngay
+    void finish(SDL_Renderer* renderer, AssetLoader& assetLoader, TextureManager& textureManager) {
+        if (!pending || world.isBuilt()) return;
+        assetLoader.finish(textureManager);
+        if (!world.level) world.begin(renderer, *pending, textureManager);
+        world.buildSome(renderer, textureManager, world.totalToBuild());
+    }
+
+    void reset(TextureManager& textureManager, BulletPool& bulletPool) {
+        world.cleanup(textureManager, bulletPool);
+        pending = nullptr;
+        targetLevel = 0;
+    }
+};